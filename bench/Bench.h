@@ -0,0 +1,57 @@
+/*
+ * Bench.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: daniel
+ */
+
+#ifndef BENCH_BENCH_H_
+#define BENCH_BENCH_H_
+
+#include "../src/json.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+using namespace elladan;
+using namespace elladan::json;
+
+// Run func `loop` times and print the best throughput over `size` bytes.
+#define EXE_BENCH(name, size, loop, func) do { \
+    double best = 0; \
+    for (int _i = 0; _i < (loop); _i++) { \
+        auto _start = std::chrono::steady_clock::now(); \
+        func; \
+        std::chrono::duration<double> _elapsed = std::chrono::steady_clock::now() - _start; \
+        double mbs = (size) / (1024.0 * 1024.0) / _elapsed.count(); \
+        if (mbs > best) best = mbs; \
+    } \
+    printf("%-40s %10.1f MB/s\n", name, best); \
+} while (0)
+
+// Size of the generated document, in MiB. Can be overridden by the first argument.
+static inline size_t benchSize(int argc, char **argv, size_t def) {
+    return (argc > 1 ? strtoul(argv[1], nullptr, 10) : def) * 1024 * 1024;
+}
+
+// Generate a document made of a large array of small mixed objects.
+static inline std::string benchDocument(size_t size) {
+    std::string doc;
+    doc.reserve(size + 256);
+    doc += "[";
+    for (size_t i = 0; doc.size() < size; i++) {
+        if (i) doc += ",\n";
+        doc += "{\"id\":" + std::to_string(i) +
+               ",\"name\":\"element number " + std::to_string(i) + "\"" +
+               ",\"ratio\":" + std::to_string(i * 0.25) +
+               ",\"active\":" + (i % 2 ? "true" : "false") +
+               ",\"tags\":[\"alpha\",\"beta\",\"gamma\"]" +
+               ",\"pos\":{\"x\":" + std::to_string(i % 1000) + ",\"y\":-" + std::to_string(i % 77) + "}}";
+    }
+    doc += "]";
+    return doc;
+}
+
+#endif /* BENCH_BENCH_H_ */
@@ -0,0 +1,40 @@
+/*
+ * BsonDocumentsBench.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: daniel
+ */
+
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include "Bench.h"
+
+int main(int argc, char **argv) {
+    // The elements of benchDocument(), one bson document each.
+    Json_t elements = Json::parse(benchDocument(benchSize(argc, argv, 32)), DecodingOption(), StreamFormat::JSON);
+    std::ostringstream out;
+    for (const Json_t& ele : elements->toArray()->value)
+        ele->write(&out, EncodingOption(), StreamFormat::BSON);
+    std::string data = out.str();
+    printf("Dump size : %zu bytes, %zu documents\n", data.size(), elements->toArray()->value.size());
+
+    EXE_BENCH("Json::read, one document per call", data.size(), 3, {
+        std::istringstream in(data);
+        std::vector<Json_t> documents;
+        while (in.peek() != EOF)
+            documents.push_back(Json::read(&in, DecodingOption(), StreamFormat::BSON));
+    });
+
+    unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned threads = 1; threads <= cores; threads *= 2) {
+        std::string name = "Json::readBsonDocuments(" + std::to_string(threads) + " threads)";
+        EXE_BENCH(name.c_str(), data.size(), 3, {
+            std::istringstream in(data);
+            std::vector<Json_t> documents = Json::readBsonDocuments(&in, DecodingOption(), threads);
+        });
+    }
+
+    return 0;
+}
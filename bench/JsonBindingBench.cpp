@@ -0,0 +1,121 @@
+/*
+ * JsonBindingBench.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: daniel
+ */
+
+#include <sstream>
+#include <vector>
+
+#include "Bench.h"
+#include "../src/serializer/JsonBinding.h"
+
+// The elements of benchDocument().
+struct Pos {
+    int64_t x = 0;
+    int64_t y = 0;
+};
+JSON_BIND(Pos, JSON_FIELD(x), JSON_FIELD(y))
+
+struct Element {
+    int64_t id = 0;
+    std::string name;
+    double ratio = 0;
+    bool active = false;
+    std::vector<std::string> tags;
+    Pos pos;
+};
+JSON_BIND(Element, JSON_FIELD(id), JSON_FIELD(name), JSON_FIELD(ratio), JSON_FIELD(active), JSON_FIELD(tags), JSON_FIELD(pos))
+
+// A bson document is an object.
+struct Batch {
+    std::vector<Element> elements;
+};
+JSON_BIND(Batch, JSON_FIELD(elements))
+
+// What is done without the binding : build the tree and copy the fields out of it.
+static std::vector<Element> fromTree(const Json_t& root) {
+    std::vector<Element> retVal;
+    for (const Json_t& ite : std::static_pointer_cast<JsonArray>(root)->value) {
+        const JsonObject* obj = static_cast<const JsonObject*>(ite.get());
+        Element ele;
+        ele.id = obj->getValueOrDefault<int64_t>("id", 0);
+        ele.name = obj->getValueOrDefault<std::string>("name", "");
+        ele.ratio = obj->getValueOrDefault<double>("ratio", 0);
+        ele.active = obj->getValueOrDefault<bool>("active", false);
+        for (const Json_t& tag : std::static_pointer_cast<JsonArray>(obj->value.find("tags")->second)->value)
+            ele.tags.push_back(fromJson<std::string>(tag));
+        const JsonObject* pos = static_cast<const JsonObject*>(obj->value.find("pos")->second.get());
+        ele.pos.x = pos->getValueOrDefault<int64_t>("x", 0);
+        ele.pos.y = pos->getValueOrDefault<int64_t>("y", 0);
+        retVal.push_back(ele);
+    }
+    return retVal;
+}
+
+static Json_t toTree(const std::vector<Element>& elements) {
+    JsonArray_t retVal = std::make_shared<JsonArray>();
+    for (const Element& ele : elements) {
+        JsonObject_t obj = std::make_shared<JsonObject>();
+        obj->value["id"] = toJson(ele.id);
+        obj->value["name"] = toJson(ele.name);
+        obj->value["ratio"] = toJson(ele.ratio);
+        obj->value["active"] = toJson(ele.active);
+        JsonArray_t tags = std::make_shared<JsonArray>();
+        for (const std::string& tag : ele.tags)
+            tags->value.push_back(toJson(tag));
+        obj->value["tags"] = tags;
+        JsonObject_t pos = std::make_shared<JsonObject>();
+        pos->value["x"] = toJson(ele.pos.x);
+        pos->value["y"] = toJson(ele.pos.y);
+        obj->value["pos"] = pos;
+        retVal->value.push_back(obj);
+    }
+    return retVal;
+}
+
+int main(int argc, char **argv) {
+    std::string doc = benchDocument(benchSize(argc, argv, 32));
+    printf("Document size : %zu bytes\n", doc.size());
+
+    EXE_BENCH("Json::parse + getValueOrDefault", doc.size(), 3, {
+        std::vector<Element> elements = fromTree(Json::parse(doc, DecodingOption(), StreamFormat::JSON));
+    });
+
+    EXE_BENCH("JsonBinding::parse", doc.size(), 3, {
+        std::vector<Element> elements;
+        JsonBinding::parse(doc, elements, DecodingOption(), StreamFormat::JSON);
+    });
+
+    std::vector<Element> elements;
+    JsonBinding::parse(doc, elements, DecodingOption(), StreamFormat::JSON);
+
+    EXE_BENCH("toJson + Json::write", doc.size(), 3, {
+        std::ostringstream out;
+        toTree(elements)->write(&out, EncodingOption(), StreamFormat::JSON);
+    });
+
+    EXE_BENCH("JsonBinding::write", doc.size(), 3, {
+        std::ostringstream out;
+        JsonBinding::write(&out, elements, EncodingOption(), StreamFormat::JSON);
+    });
+
+    Batch batch;
+    batch.elements = elements;
+    std::ostringstream bson;
+    JsonBinding::write(&bson, batch, EncodingOption(), StreamFormat::BSON);
+    std::string raw = bson.str();
+
+    EXE_BENCH("Json::parse(bson) + getValueOrDefault", raw.size(), 3, {
+        Json_t root = Json::parse(raw, DecodingOption(), StreamFormat::BSON);
+        std::vector<Element> copy = fromTree(std::static_pointer_cast<JsonObject>(root)->value.find("elements")->second);
+    });
+
+    EXE_BENCH("JsonBinding::parse(bson)", raw.size(), 3, {
+        Batch copy;
+        JsonBinding::parse(raw, copy, DecodingOption(), StreamFormat::BSON);
+    });
+
+    return 0;
+}
@@ -0,0 +1,69 @@
+/*
+ * JsonDepthBench.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: daniel
+ */
+
+#include <sstream>
+
+#include "Bench.h"
+
+// Array of elements nested `depth` levels deep.
+static std::string deepDocument(size_t size, size_t depth) {
+    std::string element;
+    for (size_t i = 0; i < depth; i++)
+        element += i % 2 ? "[" : "{\"k\":";
+    element += "1";
+    for (size_t i = depth; i-- > 0; )
+        element += i % 2 ? "]" : "}";
+
+    std::string doc = "[";
+    while (doc.size() < size)
+        doc += (doc.size() > 1 ? "," : "") + element;
+    return doc + "]";
+}
+
+static std::string toBson(const std::string& doc) {
+    std::stringstream bson;
+    Json_t obj = Json::parse("{\"doc\":" + doc + "}", DecodingOption(), StreamFormat::JSON);
+    obj->write(&bson, EncodingOption(), StreamFormat::BSON);
+    return bson.str();
+}
+
+int main(int argc, char **argv) {
+    size_t size = benchSize(argc, argv, 16);
+    std::string wide = benchDocument(size);
+    std::string deep = deepDocument(size, 64);
+    std::string deeper = deepDocument(size, 1000);
+
+    EXE_BENCH("Json::parse(wide)", wide.size(), 3, {
+        Json_t obj = Json::parse(wide, DecodingOption(), StreamFormat::JSON);
+    });
+
+    EXE_BENCH("Json::parse(depth 64)", deep.size(), 3, {
+        Json_t obj = Json::parse(deep, DecodingOption(), StreamFormat::JSON);
+    });
+
+    EXE_BENCH("Json::parse(depth 1000)", deeper.size(), 3, {
+        Json_t obj = Json::parse(deeper, DecodingOption(), StreamFormat::JSON);
+    });
+
+    std::string wideBson = toBson(wide);
+    std::string deepBson = toBson(deep);
+    std::string deeperBson = toBson(deeper);
+
+    EXE_BENCH("Bson parse(wide)", wideBson.size(), 3, {
+        Json_t obj = Json::parse(wideBson, DecodingOption(), StreamFormat::BSON);
+    });
+
+    EXE_BENCH("Bson parse(depth 64)", deepBson.size(), 3, {
+        Json_t obj = Json::parse(deepBson, DecodingOption(), StreamFormat::BSON);
+    });
+
+    EXE_BENCH("Bson parse(depth 1000)", deeperBson.size(), 3, {
+        Json_t obj = Json::parse(deeperBson, DecodingOption(), StreamFormat::BSON);
+    });
+
+    return 0;
+}
@@ -0,0 +1,90 @@
+/*
+ * JsonDocumentBench.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: daniel
+ */
+
+#include <atomic>
+#include <new>
+
+#include "Bench.h"
+#include "../src/serializer/JsonDocument.h"
+
+// Count the live heap bytes, the size is kept in front of every block.
+static std::atomic<size_t> liveBytes(0);
+
+void* operator new(size_t size) {
+    size_t* block = static_cast<size_t*>(malloc(size + 16));
+    if (!block)
+        throw std::bad_alloc();
+    *block = size;
+    liveBytes += size;
+    return reinterpret_cast<char*>(block) + 16;
+}
+
+void operator delete(void* ptr) noexcept {
+    if (!ptr)
+        return;
+    size_t* block = reinterpret_cast<size_t*>(static_cast<char*>(ptr) - 16);
+    liveBytes -= *block;
+    free(block);
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+    operator delete(ptr);
+}
+
+static void printBytes(const char* name, size_t bytes) {
+    printf("%-40s %10.1f MiB\n", name, bytes / (1024.0 * 1024.0));
+}
+
+int main(int argc, char **argv) {
+    std::string doc = benchDocument(benchSize(argc, argv, 32));
+    printf("Document size : %zu bytes\n", doc.size());
+
+    // Read a few values out of the whole document.
+    EXE_BENCH("Json::parse + getChild", doc.size(), 3, {
+        Json_t obj = Json::parse(doc, DecodingOption(), StreamFormat::JSON);
+        std::vector<Json_t> found = Json::getChild(obj, "/1000/pos");
+    });
+
+    EXE_BENCH("JsonDocument + getChild", doc.size(), 3, {
+        JsonDocument lazy(doc.data(), doc.size(), DecodingOption());
+        std::vector<Json_t> found = lazy.getChild("/1000/pos");
+    });
+
+    EXE_BENCH("JsonDocument + root()[1000]", doc.size(), 3, {
+        JsonDocument lazy(doc.data(), doc.size(), DecodingOption());
+        Json_t found = lazy.root()[1000]["pos"].get();
+    });
+
+    // Every element, one after the other.
+    EXE_BENCH("JsonDocument + root()[i] loop", doc.size(), 3, {
+        JsonDocument lazy(doc.data(), doc.size(), DecodingOption());
+        JsonDocument::Value root = lazy.root();
+        size_t sum = 0;
+        for (size_t i = 0; i < root.size(); i++)
+            sum += root[i].size();
+    });
+
+    EXE_BENCH("JsonDocument + iterator loop", doc.size(), 3, {
+        JsonDocument lazy(doc.data(), doc.size(), DecodingOption());
+        size_t sum = 0;
+        for (JsonDocument::Value ele : lazy.root())
+            sum += ele.size();
+    });
+
+    // Heap kept by the tree and by the tape.
+    size_t before = liveBytes;
+    {
+        Json_t obj = Json::parse(doc, DecodingOption(), StreamFormat::JSON);
+        printBytes("Tree", liveBytes - before);
+    }
+    {
+        JsonDocument lazy(doc.data(), doc.size(), DecodingOption());
+        printBytes("Tape", liveBytes - before);
+    }
+
+    return 0;
+}
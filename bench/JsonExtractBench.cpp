@@ -0,0 +1,57 @@
+/*
+ * JsonExtractBench.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: daniel
+ */
+
+#include <streambuf>
+#include <vector>
+
+#include "Bench.h"
+
+// Read the document in place, a 1 GB istringstream copy would not fit next to it.
+class MemBuf : public std::streambuf {
+public:
+    MemBuf(const std::string& data) {
+        char* begin = const_cast<char*>(data.data());
+        setg(begin, begin, begin + data.size());
+    }
+
+protected:
+    pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which) {
+        if (dir != std::ios_base::cur)
+            return pos_type(off_type(-1));
+        gbump(off);
+        return gptr() - eback();
+    }
+};
+
+int main(int argc, char **argv) {
+    // The field is at the very end, the whole document has to be scanned.
+    std::string doc = "{\"data\":";
+    doc += benchDocument(benchSize(argc, argv, 1024));
+    doc += ",\"summary\":{\"count\":42}}";
+    printf("Document size : %zu bytes\n", doc.size());
+
+    EXE_BENCH("Json::extract(/summary/count)", doc.size(), 3, {
+        MemBuf buf(doc);
+        std::istream in(&buf);
+        std::vector<Json_t> result = Json::extract(&in, DecodingOption(), StreamFormat::JSON, "/summary/count");
+        if (result.size() != 1)
+            printf("Could not extract the field\n");
+    });
+
+    // Decoding the whole tree first needs many times the document size in memory.
+    if (doc.size() <= 256 * 1024 * 1024) {
+        EXE_BENCH("Json::parse + getChild", doc.size(), 3, {
+            std::vector<Json_t> result = Json::getChild(Json::parse(doc, DecodingOption(), StreamFormat::JSON), "/summary/count");
+            if (result.size() != 1)
+                printf("Could not extract the field\n");
+        });
+    }
+    else
+        printf("%-40s %15s\n", "Json::parse + getChild", "skipped");
+
+    return 0;
+}
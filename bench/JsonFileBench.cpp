@@ -0,0 +1,77 @@
+/*
+ * JsonFileBench.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: daniel
+ */
+
+#include <cstdio>
+#include <fstream>
+#include <vector>
+
+#include "Bench.h"
+
+int main(int argc, char **argv) {
+    std::string doc = benchDocument(benchSize(argc, argv, 32));
+    const char* jsonFile = "bench.json";
+    const char* bsonFile = "bench.bson";
+
+    {
+        std::ofstream file(jsonFile);
+        file << doc;
+    }
+
+    // Records carrying a binary blob each, as in our dumps.
+    JsonObject_t root = std::make_shared<JsonObject>();
+    JsonArray_t records = std::make_shared<JsonArray>();
+    std::string blob(2048, 'a');
+    size_t bsonSize = 0;
+    for (size_t i = 0; bsonSize < doc.size(); i++, bsonSize += blob.size() / 2 + 64) {
+        JsonObject_t rec = std::make_shared<JsonObject>();
+        rec->value["id"] = std::make_shared<JsonInt>(i);
+        rec->value["name"] = std::make_shared<JsonString>("record " + std::to_string(i));
+        rec->value["payload"] = std::make_shared<JsonBinary>(std::make_shared<Binary>(blob));
+        records->value.push_back(rec);
+    }
+    root->value["records"] = records;
+    {
+        std::ofstream file(bsonFile, std::ios::binary);
+        root->write(&file, EncodingOption(), StreamFormat::BSON);
+    }
+    printf("Document size : %zu bytes json, %zu bytes bson\n", doc.size(), bsonSize);
+
+    EXE_BENCH("Json::read(ifstream)", doc.size(), 3, {
+        std::ifstream file(jsonFile);
+        Json_t obj = Json::read(&file, DecodingOption(), StreamFormat::JSON);
+    });
+
+    EXE_BENCH("Json::readFile", doc.size(), 3, {
+        Json_t obj = Json::readFile(jsonFile, DecodingOption(), StreamFormat::JSON);
+    });
+
+    EXE_BENCH("Json::read(ifstream, bson)", bsonSize, 3, {
+        std::ifstream file(bsonFile, std::ios::binary);
+        Json_t obj = Json::read(&file, DecodingOption(), StreamFormat::BSON);
+    });
+
+    EXE_BENCH("Json::readFile(bson)", bsonSize, 3, {
+        Json_t obj = Json::readFile(bsonFile, DecodingOption(), StreamFormat::BSON);
+    });
+
+    EXE_BENCH("Json::readFile(bson, borrowed binaries)", bsonSize, 3, {
+        Json_t obj = Json::readFile(bsonFile, DF_BORROW_BINARY, StreamFormat::BSON);
+    });
+
+    EXE_BENCH("Json::extract(ifstream, bson)", bsonSize, 3, {
+        std::ifstream file(bsonFile, std::ios::binary);
+        std::vector<Json_t> found = Json::extract(&file, DecodingOption(), StreamFormat::BSON, "/records/1000/payload");
+    });
+
+    EXE_BENCH("Json::extractFile(bson)", bsonSize, 3, {
+        std::vector<Json_t> found = Json::extractFile(bsonFile, DecodingOption(), StreamFormat::BSON, "/records/1000/payload");
+    });
+
+    std::remove(jsonFile);
+    std::remove(bsonFile);
+    return 0;
+}
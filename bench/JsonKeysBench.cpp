@@ -0,0 +1,79 @@
+/*
+ * JsonKeysBench.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: daniel
+ */
+
+#include <chrono>
+
+#include "Bench.h"
+
+// Records repeating the same keys.
+static std::string keysDocument(size_t size) {
+    std::string doc = "[";
+    for (size_t i = 0; doc.size() < size; i++) {
+        if (i) doc += ",\n";
+        doc += "{\"id\":" + std::to_string(i) +
+               ",\"customer_identifier\":" + std::to_string(i % 5000) +
+               ",\"transaction_timestamp\":" + std::to_string(1700000000 + i) +
+               ",\"currency\":\"EUR\",\"amount_in_cents\":" + std::to_string(i % 100000) +
+               ",\"shipping_address_country\":\"FR\",\"status\":\"done\"}";
+    }
+    doc += "]";
+    return doc;
+}
+
+// Best parse time of one object of `keys` members.
+static double objectSeconds(size_t keys, DecodingOption flag) {
+    std::string doc = "{";
+    for (size_t i = 0; i < keys; i++)
+        doc += (i ? ",\"key" : "\"key") + std::to_string(i) + "\":" + std::to_string(i);
+    doc += "}";
+
+    double best = 0;
+    for (int i = 0; i < 3; i++) {
+        auto start = std::chrono::steady_clock::now();
+        Json_t obj = Json::parse(doc, flag, StreamFormat::JSON);
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        if (!i || elapsed.count() < best)
+            best = elapsed.count();
+    }
+    return best;
+}
+
+// Adding the members of a large object must stay linear, duplicates checked or not.
+// Doubling the keys doubles a linear parse time, a quadratic one is 4 times longer : stop there.
+static bool largeObjects() {
+    for (DecodingOption flag : {DecodingOption(), DecodingOption(DF_REJECT_DUPLICATE)}) {
+        const char* name = flag.test(DecodingFlags::DF_REJECT_DUPLICATE) ? " (reject duplicate)" : "";
+        double prev = 0;
+        for (size_t keys = 5000; keys <= 80000; keys *= 2) {
+            double time = objectSeconds(keys, flag);
+            char label[64];
+            snprintf(label, sizeof(label), "Object of %zu keys%s", keys, name);
+            printf("%-40s %10.3f s\n", label, time);
+            if (prev && time > 3.5 * prev) {
+                printf("Quadratic parse of large objects%s : %.1f times longer for twice the keys\n", name, time / prev);
+                return false;
+            }
+            prev = time;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char **argv) {
+    std::string doc = keysDocument(benchSize(argc, argv, 32));
+    printf("Document size : %zu bytes\n", doc.size());
+
+    EXE_BENCH("Json::parse", doc.size(), 3, {
+        Json_t obj = Json::parse(doc, DecodingOption(), StreamFormat::JSON);
+    });
+
+    EXE_BENCH("Json::parse(reject duplicate)", doc.size(), 3, {
+        Json_t obj = Json::parse(doc, DF_REJECT_DUPLICATE, StreamFormat::JSON);
+    });
+
+    return largeObjects() ? 0 : 1;
+}
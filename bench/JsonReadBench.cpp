@@ -0,0 +1,77 @@
+/*
+ * JsonReadBench.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: daniel
+ */
+
+#include <sstream>
+#include <vector>
+
+#include "Bench.h"
+
+int main(int argc, char **argv) {
+    std::string doc = benchDocument(benchSize(argc, argv, 32));
+    printf("Document size : %zu bytes\n", doc.size());
+
+    EXE_BENCH("Json::read(istream)", doc.size(), 3, {
+        std::istringstream ss(doc);
+        Json_t obj = Json::read(&ss, DecodingOption(), StreamFormat::JSON);
+    });
+
+    EXE_BENCH("Json::parse(memory)", doc.size(), 3, {
+        Json_t obj = Json::parse(doc, DecodingOption(), StreamFormat::JSON);
+    });
+
+    EXE_BENCH("Json::parse(structural index)", doc.size(), 3, {
+        Json_t obj = Json::parse(doc, DF_STRUCTURAL_INDEX, StreamFormat::JSON);
+    });
+
+    EXE_BENCH("Json::parse(parallel array)", doc.size(), 3, {
+        Json_t obj = Json::parse(doc, DF_PARALLEL, StreamFormat::JSON);
+    });
+
+    EXE_BENCH("Json::parse(parallel + index)", doc.size(), 3, {
+        Json_t obj = Json::parse(doc, DecodingOption(DF_PARALLEL | DF_STRUCTURAL_INDEX), StreamFormat::JSON);
+    });
+
+    // Mostly long strings, without escapes.
+    std::string text = "[";
+    for (size_t i = 0; text.size() < doc.size(); i++)
+        text += std::string(i ? "," : "") + "\"" + std::string(200 + i % 50, 'a' + i % 26) + (i % 10 ? "" : "\\n") + "\"";
+    text += "]";
+
+    EXE_BENCH("Json::parse(strings)", text.size(), 3, {
+        Json_t obj = Json::parse(text, DecodingOption(), StreamFormat::JSON);
+    });
+
+    // Metrics like array of numbers.
+    std::string numbers = "[";
+    for (size_t i = 0; numbers.size() < doc.size(); i++) {
+        char val[64];
+        snprintf(val, sizeof(val), i % 2 ? "%.17g," : "%zu,", i % 2 ? i * 1.0137e-3 : i * 7919);
+        numbers += val;
+    }
+    numbers.back() = ']';
+
+    EXE_BENCH("Json::parse(numbers)", numbers.size(), 3, {
+        Json_t obj = Json::parse(numbers, DecodingOption(), StreamFormat::JSON);
+    });
+
+    // Same elements, one per line.
+    std::string lines = doc.substr(1, doc.size() - 2);
+    for (size_t i = 0; (i = lines.find(",\n", i)) != std::string::npos; i++)
+        lines[i] = ' ';
+
+    EXE_BENCH("Json::readLines(1 thread)", lines.size(), 3, {
+        std::istringstream ss(lines);
+        std::vector<Json_t> records = Json::readLines(&ss, DecodingOption(), 1);
+    });
+
+    EXE_BENCH("Json::readLines(all cores)", lines.size(), 3, {
+        std::istringstream ss(lines);
+        std::vector<Json_t> records = Json::readLines(&ss, DecodingOption(), 0);
+    });
+
+    return 0;
+}
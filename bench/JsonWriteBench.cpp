@@ -0,0 +1,166 @@
+/*
+ * JsonWriteBench.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: daniel
+ */
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+#include "Bench.h"
+#include "../src/serializer/JsonWriter.h"
+#include "../src/serializer/OutputSink.h"
+
+static void writeRecords(JsonHandler& out, size_t count) {
+    out.beginObject().key("records").beginArray();
+    for (size_t i = 0; i < count; i++) {
+        out.beginObject()
+            .key("id").value(i)
+            .key("name").value("element number " + std::to_string(i))
+            .key("ratio").value(i * 0.25)
+            .key("active").value(i % 2 == 1)
+            .key("tags").beginArray().value("alpha").value("beta").value("gamma").endArray()
+        .endObject();
+    }
+    out.endArray().endObject();
+}
+
+int main(int argc, char **argv) {
+    std::string doc = benchDocument(benchSize(argc, argv, 32));
+    Json_t root = Json::parse(doc, DecodingOption(), StreamFormat::JSON);
+
+    std::string out;
+    root->write(out, EncodingOption(), StreamFormat::JSON);
+    size_t size = out.size();
+    printf("Document size : %zu bytes\n", size);
+
+    EXE_BENCH("Json::write(stringstream)", size, 3, {
+        std::stringstream ss;
+        root->write(&ss, EncodingOption(), StreamFormat::JSON);
+    });
+
+    EXE_BENCH("Json::write(ofstream)", size, 3, {
+        std::ofstream file("/dev/null");
+        root->write(&file, EncodingOption(), StreamFormat::JSON);
+    });
+
+    EncodingOption indent;
+    indent.setIndent(3);
+    EXE_BENCH("Json::write(stringstream, indent)", size, 3, {
+        std::stringstream ss;
+        root->write(&ss, indent, StreamFormat::JSON);
+    });
+
+    EncodingOption sorted(EncodingFlags::EF_JSON_SORT_KEY);
+    EXE_BENCH("Json::write(string, sorted keys)", size, 3, {
+        std::string str;
+        root->write(str, sorted, StreamFormat::JSON);
+    });
+
+    std::string bson;
+    root->write(bson, EncodingOption(), StreamFormat::BSON);
+    EXE_BENCH("Json::write(string, bson)", bson.size(), 3, {
+        std::string str;
+        root->write(str, EncodingOption(), StreamFormat::BSON);
+    });
+
+    EXE_BENCH("Json::write(string, bson, sorted keys)", bson.size(), 3, {
+        std::string str;
+        root->write(str, sorted, StreamFormat::BSON);
+    });
+
+    EXE_BENCH("Json::write(string)", size, 3, {
+        std::string str;
+        root->write(str, EncodingOption(), StreamFormat::JSON);
+    });
+
+    std::vector<char> buffer(size);
+    EXE_BENCH("Json::write(buffer)", size, 3, {
+        root->write(buffer.data(), buffer.size(), EncodingOption(), StreamFormat::JSON);
+    });
+
+    int fd = open("/dev/null", O_WRONLY);
+    EXE_BENCH("Json::write(fd)", size, 3, {
+        root->write(fd, EncodingOption(), StreamFormat::JSON);
+    });
+    close(fd);
+
+    EXE_BENCH("to_string", size, 3, {
+        std::string str = std::to_string(root);
+    });
+
+    // Long texts, with a few characters to escape.
+    JsonArray_t texts = std::make_shared<JsonArray>();
+    std::string text;
+    for (int i = 0; text.size() < 4096; i++)
+        text += i % 16 ? "some plain words " : "a \"quote\", caf\xc3\xa9\n";
+    for (size_t i = 0; i * text.size() < size; i++)
+        texts->value.push_back(toJson(text));
+    EXE_BENCH("Json::write(string, long strings)", texts->value.size() * text.size(), 3, {
+        std::string str;
+        texts->write(str, EncodingOption(), StreamFormat::JSON);
+    });
+
+    // A response made of records, through a tree or straight to the output.
+    const size_t records = 200000;
+    std::string response;
+    {
+        StringSink sink(response);
+        JsonWriter writer(sink);
+        writeRecords(writer, records);
+    }
+    EXE_BENCH("tree + Json::write(string)", response.size(), 3, {
+        JsonBuilder builder;
+        writeRecords(builder, records);
+        std::string str;
+        builder.get()->write(str, EncodingOption(), StreamFormat::JSON);
+    });
+    EXE_BENCH("JsonWriter(string)", response.size(), 3, {
+        std::string str;
+        StringSink sink(str);
+        JsonWriter writer(sink);
+        writeRecords(writer, records);
+    });
+    EXE_BENCH("BsonWriter(string)", response.size(), 3, {
+        std::string str;
+        StringSink sink(str);
+        BsonWriter writer(sink);
+        writeRecords(writer, records);
+    });
+
+    // Counters, of all magnitudes.
+    JsonArray_t counters = std::make_shared<JsonArray>();
+    for (uint64_t i = 0; i < 10000000; i++)
+        counters->value.push_back(toJson((int64_t) ((i * 0x9E3779B97F4A7C15ULL) >> (i % 60))));
+    std::string countersOut;
+    counters->write(countersOut, EncodingOption(), StreamFormat::JSON);
+    std::vector<char> countersBuffer(countersOut.size());
+    EXE_BENCH("Json::write(buffer, 10M integers)", countersOut.size(), 3, {
+        counters->write(countersBuffer.data(), countersBuffer.size(), EncodingOption(), StreamFormat::JSON);
+    });
+    counters.reset();
+
+    // Reals, of all magnitudes.
+    JsonArray_t reals = std::make_shared<JsonArray>();
+    for (size_t i = 0; i < 2000000; i++)
+        reals->value.push_back(toJson((i % 2 ? 1 : -1) * (double) (i * 2654435761u % 1000003) / (1 + i % 997) * (i % 5 ? 1 : 1e-12)));
+    std::string realsOut;
+    reals->write(realsOut, EncodingOption(), StreamFormat::JSON);
+    EXE_BENCH("Json::write(string, reals)", realsOut.size(), 3, {
+        std::string str;
+        reals->write(str, EncodingOption(), StreamFormat::JSON);
+    });
+
+    EncodingOption prec;
+    prec.setRealPrec(6);
+    EXE_BENCH("Json::write(string, reals, 6 digits)", realsOut.size(), 3, {
+        std::string str;
+        reals->write(str, prec, StreamFormat::JSON);
+    });
+
+    return 0;
+}
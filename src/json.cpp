@@ -10,13 +10,18 @@
 #include <elladan/Exception.h>
 #include <elladan/Stringify.h>
 #include <stdlib.h>
+#include <algorithm>
 #include <cstring>
 #include <sstream>
 #include <utility>
 #include <cassert>
 
+#include "serializer/BsonDocuments.h"
 #include "serializer/BsonSerializer.h"
+#include "serializer/JsonLines.h"
 #include "serializer/JsonSerializer.h"
+#include "serializer/MappedFile.h"
+#include "serializer/OutputSink.h"
 
 bool operator !=(const elladan::json::Json_t& left, const elladan::json::Json_t& right) {
     if (!left.get() && !right.get()) return false;
@@ -144,6 +149,30 @@ void Json::write(std::ostream* out, EncodingOption flags, StreamFormat format){
     }
 }
 
+void Json::write(OutputSink& out, EncodingOption flags, StreamFormat format){
+    switch (format) {
+        case StreamFormat::JSON:    JsonSerializer::write(out, this, flags);            break;
+        case StreamFormat::BSON:    BsonSerializer::write(out, this, flags);            break;
+        default:                    throw Exception("Unknown stream format");
+    }
+}
+
+void Json::write(std::string& out, EncodingOption flags, StreamFormat format){
+    StringSink sink(out);
+    write(sink, flags, format);
+}
+
+size_t Json::write(char* buffer, size_t size, EncodingOption flags, StreamFormat format){
+    BufferSink sink(buffer, size);
+    write(sink, flags, format);
+    return sink.size();
+}
+
+void Json::write(int fd, EncodingOption flags, StreamFormat format){
+    FdSink sink(fd);
+    write(sink, flags, format);
+}
+
 Json_t Json::read(std::istream* input, DecodingOption flags, StreamFormat format){
     switch (format) {
         case StreamFormat::JSON:     return JsonSerializer::read(input, flags);
@@ -152,6 +181,34 @@ Json_t Json::read(std::istream* input, DecodingOption flags, StreamFormat format
     }
 }
 
+Json_t Json::parse(const char* data, size_t size, DecodingOption flags, StreamFormat format){
+    switch (format) {
+        case StreamFormat::JSON:    return JsonSerializer::parse(data, size, flags);
+        case StreamFormat::BSON:    return BsonSerializer::parse(data, size, flags);
+        default:                    throw Exception("Unknown stream format");
+    }
+}
+
+Json_t Json::parse(const std::string& data, DecodingOption flags, StreamFormat format){
+    return parse(data.c_str(), data.size(), flags, format);
+}
+
+void Json::read(std::istream* input, JsonHandler& handler, DecodingOption flags, StreamFormat format){
+    switch (format) {
+        case StreamFormat::JSON:    JsonSerializer::read(input, handler, flags); break;
+        case StreamFormat::BSON:    BsonSerializer::read(input, handler, flags); break;
+        default:                    throw Exception("Unknown stream format");
+    }
+}
+
+void Json::parse(const char* data, size_t size, JsonHandler& handler, DecodingOption flags, StreamFormat format){
+    switch (format) {
+        case StreamFormat::JSON:    JsonSerializer::parse(data, size, handler, flags); break;
+        case StreamFormat::BSON:    BsonSerializer::parse(data, size, handler, flags); break;
+        default:                    throw Exception("Unknown stream format");
+    }
+}
+
 std::vector<Json_t> Json::extract(std::istream* input, DecodingOption flags, StreamFormat format, const std::string& path){
     switch (format) {
         case StreamFormat::JSON:     return JsonSerializer::extract(input, flags, path);
@@ -160,6 +217,40 @@ std::vector<Json_t> Json::extract(std::istream* input, DecodingOption flags, Str
     }
 }
 
+Json_t Json::readFile(const std::string& fileName, DecodingOption flags, StreamFormat format){
+    std::shared_ptr<MappedFile> file = std::make_shared<MappedFile>(fileName);
+    switch (format) {
+        case StreamFormat::JSON:    return JsonSerializer::parse(file->data(), file->size(), flags);
+        case StreamFormat::BSON:    return BsonSerializer::parse(file, flags);
+        default:                    throw Exception("Unknown stream format");
+    }
+}
+
+std::vector<Json_t> Json::extractFile(const std::string& fileName, DecodingOption flags, StreamFormat format, const std::string& path){
+    std::shared_ptr<MappedFile> file = std::make_shared<MappedFile>(fileName);
+    switch (format) {
+        case StreamFormat::JSON:    return JsonSerializer::extract(file->data(), file->size(), flags, path);
+        case StreamFormat::BSON:    return BsonSerializer::extract(file, flags, path);
+        default:                    throw Exception("Unknown stream format");
+    }
+}
+
+std::vector<Json_t> Json::readLines(std::istream* input, DecodingOption flags, unsigned threads){
+    return JsonLines::read(input, flags, threads);
+}
+
+void Json::readLines(std::istream* input, const std::function<void(const Json_t&)>& callback, DecodingOption flags, unsigned threads){
+    JsonLines::read(input, callback, flags, threads);
+}
+
+std::vector<Json_t> Json::readBsonDocuments(std::istream* input, DecodingOption flags, unsigned threads){
+    return BsonDocuments::read(input, flags, threads);
+}
+
+void Json::readBsonDocuments(std::istream* input, const std::function<void(const Json_t&)>& callback, DecodingOption flags, unsigned threads){
+    BsonDocuments::read(input, callback, flags, threads);
+}
+
 
 #define TO(Type, TYPE) \
 Json##Type* Json::to##Type() { assert(getType() == TYPE); return static_cast<Json##Type*>(this); }\
@@ -298,6 +389,15 @@ int JsonObject::cmp (const Json* right) const {
 
     return 0;
 }
+std::vector<const JsonObject::Member*> JsonObject::sortedMembers() const {
+    std::vector<const Member*> retVal;
+    retVal.reserve(value.size());
+    for (const auto& ite : value)
+        retVal.push_back(&ite);
+    std::stable_sort(retVal.begin(), retVal.end(), [](const Member* a, const Member* b) { return a->first < b->first; });
+    return retVal;
+}
+
 Json_t JsonObject::deep_copy() const{
     JsonObject_t array = std::make_shared<JsonObject>();
     for (auto ite : value)
@@ -418,9 +518,9 @@ namespace std {
 std::string to_string (elladan::json::Json_t val)
 {
     if (!val) return "none";
-    std::stringstream str;
-    val->write(&str, elladan::json::EncodingFlags(), elladan::json::StreamFormat::JSON);
-    return str.str();
+    std::string str;
+    val->write(str, elladan::json::EncodingFlags(), elladan::json::StreamFormat::JSON);
+    return str;
 }
 
 std::string to_string (elladan::json::JsonType type){
@@ -7,6 +7,7 @@
 #include <stddef.h>
 #include <stdint.h>
 #include <bitset>
+#include <functional>
 #include <iostream>
 #include <memory>
 #include <string>
@@ -20,6 +21,9 @@ class UUID;
 
 namespace json {
 
+class JsonHandler;
+class OutputSink;
+
 enum JsonType {
    JSON_NONE,
    JSON_NULL,
@@ -35,9 +39,12 @@ enum JsonType {
 
 enum DecodingFlags {
    DF_ALLOW_NULL          = 1 << 0, /// If set, null value will NOT throw an error. Always on in bson
-   DF_REJECT_DUPLICATE    = 1 << 1, /// If set, an error will be thrown if a map index appear multiple time within the map. FIXME: NOT supported in BSON.
+   DF_REJECT_DUPLICATE    = 1 << 1, /// If set, an error will be thrown if a map index appear multiple time within the map.
    DF_IGNORE_COMMENT      = 1 << 2, /// If set, c/c+++ like comments will be ignored. Ignored in bson.
    DF_ALLOW_COMMA_ERR     = 1 << 3, /// If set, I will do my best to ignore pesky comma error (missing comma at the end of a line, trailing comma at the end of a list/array, double commas). Ignored in bson.
+   DF_STRUCTURAL_INDEX    = 1 << 4, /// If set, a vectorized first pass index the structural characters and the tree is built from that index. Read the whole input at once. Ignored with DF_IGNORE_COMMENT and in bson.
+   DF_PARALLEL            = 1 << 5, /// If set, the elements of a top level array are parsed concurrently, one thread per core. Read the whole input at once. Ignored with DF_IGNORE_COMMENT and in bson.
+   DF_BORROW_BINARY       = 1 << 7, /// If set, the binaries read by Json::readFile() point into the file mapping, kept as long as one of them lives. Only in bson.
 };
 enum EncodingFlags {
    EF_JSON_ENSURE_ASCII   = 1 << 0, /// Throw error if any string are not utf compliant. Ignored in bson.
@@ -49,11 +56,23 @@ enum class StreamFormat : uint8_t {
    BSON = 1
 };
 
-typedef FlagSet DecodingOption;
+struct DecodingOption : public FlagSet
+{
+   DecodingOption() : max_depth(DEFAULT_MAX_DEPTH) {  }
+   DecodingOption(int flag) : DecodingOption() {set(flag);}
+
+   // Deepest nesting of objects/arrays accepted, an error is thrown past it.
+   static constexpr size_t DEFAULT_MAX_DEPTH = 1024;
+   void setMaxDepth(size_t depth){
+      max_depth = std::max<size_t>(1, depth);
+   }
+   inline size_t getMaxDepth() const { return max_depth; }
+   size_t max_depth;
+};
 
 struct EncodingOption : public FlagSet
 {
-   EncodingOption() : real_prec(10), ident(0) {  }
+   EncodingOption() : real_prec(0), ident(0) {  }
    EncodingOption(EncodingFlags flag) : EncodingOption() {set((int)flag);}
 
    static constexpr int MAX_INDENT_AS_TAB = 15;
@@ -62,9 +81,10 @@ struct EncodingOption : public FlagSet
    }
    inline int getIndent() const { return ident; }
 
+   // Digits written after the point of the reals. 0, the default, writes the shortest text reading back as the same double.
    static constexpr int MAX_FLOAT = 31;
    void setRealPrec(int size){
-      real_prec = std::max(1,std::min(size, MAX_FLOAT));
+      real_prec = size < 0 ? 0 : (size > MAX_FLOAT ? MAX_FLOAT : size);
    }
    inline int getRealPrec() const { return real_prec; }
    uint8_t real_prec;
@@ -91,9 +111,32 @@ public:
    Json();
    virtual ~Json();
 
+   // Json is read by blocks : the input is left right after the value if it can seek, otherwise it is
+   // read past the value and left in the fail state.
    static Json_t read(std::istream* input, DecodingOption flags, StreamFormat format);
+   static Json_t parse(const char* data, size_t size, DecodingOption flags, StreamFormat format);
+   static Json_t parse(const std::string& data, DecodingOption flags, StreamFormat format);
+   // Report the document to the handler instead of building the tree.
+   static void read(std::istream* input, JsonHandler& handler, DecodingOption flags, StreamFormat format);
+   static void parse(const char* data, size_t size, JsonHandler& handler, DecodingOption flags, StreamFormat format);
    static std::vector<Json_t> extract(std::istream* input, DecodingOption flags, StreamFormat format, const std::string& path);
+   // Map the whole file in memory and parse from the mapping. Only regular files can be mapped, read the others as streams.
+   static Json_t readFile(const std::string& fileName, DecodingOption flags, StreamFormat format);
+   static std::vector<Json_t> extractFile(const std::string& fileName, DecodingOption flags, StreamFormat format, const std::string& path);
+   // Newline delimited json, one value per line. The lines are parsed over `threads` threads (0 : one per core), in input order.
+   static std::vector<Json_t> readLines(std::istream* input, DecodingOption flags, unsigned threads = 0);
+   static void readLines(std::istream* input, const std::function<void(const Json_t&)>& callback, DecodingOption flags, unsigned threads = 0);
+   // Concatenated bson documents, each one starting with its size. The documents are decoded over `threads` threads (0 : one per core), in input order.
+   static std::vector<Json_t> readBsonDocuments(std::istream* input, DecodingOption flags, unsigned threads = 0);
+   static void readBsonDocuments(std::istream* input, const std::function<void(const Json_t&)>& callback, DecodingOption flags, unsigned threads = 0);
    void write(std::ostream* out, EncodingOption flags, StreamFormat format);
+   void write(OutputSink& out, EncodingOption flags, StreamFormat format);
+   // Append to the string.
+   void write(std::string& out, EncodingOption flags, StreamFormat format);
+   // Fill the buffer as far as it goes, return the size of the whole output : more than size when it did not fit.
+   size_t write(char* buffer, size_t size, EncodingOption flags, StreamFormat format);
+   // Write to the file descriptor, throw on error.
+   void write(int fd, EncodingOption flags, StreamFormat format);
    static std::vector<Json_t> getChild(const Json_t& ele, const std::string& path);
 
    virtual JsonType getType() const;
@@ -198,6 +241,10 @@ public:
    template <typename T>
    T getValueOrDefault(const std::string& name, const T& defaultVal) const;
 
+   typedef std::pair<std::string, Json_t> Member;
+   // The members ordered by key, without copying them. Computed on each call, as value can be changed at any time.
+   std::vector<const Member*> sortedMembers() const;
+
    elladan::VMap<std::string, Json_t> value;
    mutable bool visited; // FIXME: use it!
 };
@@ -0,0 +1,167 @@
+/*
+ * parallel.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: daniel
+ */
+
+#include "parallel.h"
+
+#include <algorithm>
+
+namespace elladan { namespace json {
+
+unsigned Parallel::threadCount(unsigned threads) {
+   if (threads)
+      return threads;
+   unsigned cores = std::thread::hardware_concurrency();
+   return cores ? cores : 1;
+}
+
+void Parallel::run(size_t count, unsigned threads, const std::function<void(size_t)>& task) {
+   threads = threadCount(threads);
+   if (threads > count)
+      threads = count ? count : 1;
+
+   ThreadPool pool(threads);
+   pool.run(count, task);
+}
+
+///////////////////////////////////
+
+ThreadPool::ThreadPool(unsigned threads) :
+   _run(0), _busy(0), _stop(false), _task(nullptr), _count(0), _next(0), _failed(0) {
+   threads = Parallel::threadCount(threads);
+   for (unsigned t = 1; t < threads; t++)
+      _workers.emplace_back([this]() { work(); });
+}
+
+ThreadPool::~ThreadPool() {
+   {
+      std::lock_guard<std::mutex> guard(_lock);
+      _stop = true;
+   }
+   _wake.notify_all();
+   for (std::thread& th : _workers)
+      th.join();
+}
+
+void ThreadPool::run(size_t count, const std::function<void(size_t)>& task) {
+   {
+      std::lock_guard<std::mutex> guard(_lock);
+      _task = &task;
+      _count = count;
+      _next = 0;
+      _failed = count;
+      _error = nullptr;
+      _busy = _workers.size();
+      _run++;
+   }
+   _wake.notify_all();
+
+   execute();
+
+   std::exception_ptr error;
+   {
+      std::unique_lock<std::mutex> guard(_lock);
+      _done.wait(guard, [this]() { return _busy == 0; });
+      _task = nullptr;
+      error = _error;
+      _error = nullptr;
+   }
+   if (error)
+      std::rethrow_exception(error);
+}
+
+void ThreadPool::work() {
+   uint64_t seen = 0;
+   while (1) {
+      {
+         std::unique_lock<std::mutex> guard(_lock);
+         _wake.wait(guard, [&]() { return _stop || _run != seen; });
+         if (_stop)
+            return;
+         seen = _run;
+      }
+
+      execute();
+
+      std::lock_guard<std::mutex> guard(_lock);
+      if (--_busy == 0)
+         _done.notify_one();
+   }
+}
+
+void ThreadPool::execute() {
+   size_t i;
+   while ((i = _next++) < _count && i < _failed) {
+      try {
+         (*_task)(i);
+      }
+      catch (...) {
+         std::lock_guard<std::mutex> guard(_lock);
+         if (i < _failed) {
+            _failed = i;
+            _error = std::current_exception();
+         }
+      }
+   }
+}
+
+///////////////////////////////////
+
+RecordBatches::RecordBatches(const Frame& frame, const Decode& decode, size_t batchSize, unsigned threads) :
+   _frame(frame), _decode(decode), _pool(threads), _batchSize(batchSize * _pool.size()), _index(0), _offset(0) {
+}
+
+void RecordBatches::decode(const Callback& callback) {
+   // A few tasks per thread, so a slow one does not hold the others.
+   size_t count = _starts.size() - 1;
+   std::vector<Json_t> records(count);
+   size_t tasks = std::min<size_t>(count, _pool.size() * 8);
+   size_t perTask = tasks ? (count + tasks - 1) / tasks : 0;
+
+   _pool.run(tasks, [&](size_t task) {
+      size_t last = std::min(count, (task + 1) * perTask);
+      for (size_t i = task * perTask; i < last; i++)
+         records[i] = _decode(_starts[i], _starts[i + 1] - _starts[i], _index + i, _offset + (_starts[i] - _starts[0]));
+   });
+
+   _index += count;
+   _offset += _starts.back() - _starts.front();
+   for (const Json_t& record : records)
+      if (record)
+         callback(record);
+}
+
+void RecordBatches::parse(const char* data, size_t size, const Callback& callback) {
+   const char* end = data + size;
+   while (data < end) {
+      data += _frame(data, end - data, _batchSize, true, _offset, _starts);
+      decode(callback);
+   }
+}
+
+void RecordBatches::read(std::istream* in, const Callback& callback) {
+   std::string buf;
+   bool eof = false;
+
+   while (!eof || !buf.empty()) {
+      if (!eof) {
+         size_t used = buf.size();
+         buf.resize(used + _batchSize);
+         in->read(&buf[used], _batchSize);
+         buf.resize(used + in->gcount());
+         eof = !*in;
+      }
+
+      // Decode the complete records, the last one is kept for the next batch.
+      size_t len = _frame(buf.data(), buf.size(), buf.size(), eof, _offset, _starts);
+      if (len) {
+         decode(callback);
+         buf.erase(0, len);
+      }
+   }
+}
+
+} }  // namespace elladan::json
@@ -0,0 +1,113 @@
+/*
+ * parallel.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: daniel
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "json.h"
+
+namespace elladan { namespace json {
+
+class Parallel {
+public:
+    // Number of threads to use : `threads`, or one per core if 0.
+    static unsigned threadCount(unsigned threads);
+
+    // Run task(0) ... task(count - 1) over `threads` threads, the calling one included.
+    // Once a task throws, the following ones are not started. The exception of the lowest task is rethrown.
+    // The threads are started for this call only, use a ThreadPool to run several times.
+    static void run(size_t count, unsigned threads, const std::function<void(size_t)>& task);
+};
+
+/**
+ * Threads kept from one run to the next, so a reader running one batch after the other starts them once.
+ * Runs are not reentrant and must come from one thread at a time.
+ */
+class ThreadPool {
+public:
+    // `threads` threads, the calling one included, or one per core if 0.
+    explicit ThreadPool(unsigned threads);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Number of threads, the calling one included.
+    unsigned size() const { return _workers.size() + 1; }
+
+    // Same as Parallel::run(), over the threads of the pool.
+    void run(size_t count, const std::function<void(size_t)>& task);
+
+protected:
+    void work();
+    // Take the tasks of the current run until there is none left.
+    void execute();
+
+    std::vector<std::thread> _workers;
+    std::mutex _lock;
+    std::condition_variable _wake;      // A run started, or the pool stops.
+    std::condition_variable _done;      // The last worker is done with the run.
+    uint64_t _run;                      // Number of runs started.
+    unsigned _busy;                     // Workers still in the current run.
+    bool _stop;
+
+    // Current run.
+    const std::function<void(size_t)>* _task;
+    size_t _count;
+    std::atomic<size_t> _next;
+    std::atomic<size_t> _failed;        // Lowest task which threw, _count if none.
+    std::exception_ptr _error;
+};
+
+/**
+ * Input made of records, cut in batches whose records are decoded over a ThreadPool and given back in input order.
+ * The format only tells where its records end and how to decode one.
+ */
+class RecordBatches {
+public:
+    // Cut the records at the start of [data, data + size), stopping once about `limit` bytes are taken.
+    // `starts` gets the start of each record then the end of the last one, the bytes taken are returned.
+    // `end` tells nothing follows size : the records must then take something, or it throws.
+    // `offset` is the position of data in the whole input, for the errors.
+    typedef std::function<size_t(const char* data, size_t size, size_t limit, bool end, size_t offset, std::vector<const char*>& starts)> Frame;
+    // Decode the record number `index` found at `offset` in the whole input. A null Json_t is not given back.
+    typedef std::function<Json_t(const char* data, size_t size, size_t index, size_t offset)> Decode;
+    typedef std::function<void(const Json_t& record)> Callback;
+
+    // batchSize : bytes per thread of a batch.
+    // threads : number of threads to use, 0 for one per core.
+    RecordBatches(const Frame& frame, const Decode& decode, size_t batchSize, unsigned threads);
+
+    void parse(const char* data, size_t size, const Callback& callback);
+    void read(std::istream* in, const Callback& callback);
+
+protected:
+    // Decode the records of _starts, then give them back.
+    void decode(const Callback& callback);
+
+    Frame _frame;
+    Decode _decode;
+    ThreadPool _pool;
+    // Keep the batches small enough to not hold the whole decoded input at once.
+    size_t _batchSize;
+    std::vector<const char*> _starts;
+    size_t _index;                      // Number of records before the batch.
+    size_t _offset;                     // Position of the batch in the whole input.
+};
+
+} }  // namespace elladan::json
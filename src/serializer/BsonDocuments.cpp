@@ -0,0 +1,80 @@
+/*
+ * BsonDocuments.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: daniel
+ */
+
+#include "BsonDocuments.h"
+
+#include <elladan/Exception.h>
+#include <stdint.h>
+#include <cstring>
+
+#include "BsonSerializer.h"
+
+using std::to_string;
+
+namespace elladan { namespace json {
+
+size_t BsonDocuments::frame(const char* data, size_t size, size_t limit, bool end, size_t offset, std::vector<const char*>& starts) {
+   starts.clear();
+   size_t pos = 0;
+   while (pos < limit && size - pos >= sizeof(uint32_t)) {
+      uint32_t len;
+      memcpy(&len, data + pos, sizeof(len));
+      // The size, at least one element type, and the end of document.
+      if (len < sizeof(len) + 1)
+         throw Exception("Invalid document size " + to_string(len) + " at location " + to_string(offset + pos));
+      if (len > size - pos)
+         break;
+
+      starts.push_back(data + pos);
+      pos += len;
+   }
+   if (end && pos == 0 && size)
+      throw Exception("Truncated document at location " + to_string(offset));
+   starts.push_back(data + pos);
+   return pos;
+}
+
+RecordBatches::Decode BsonDocuments::decoder(DecodingOption flag) {
+   return [flag](const char* document, size_t size, size_t index, size_t location) {
+      // Each document is decoded within its own size, and must end right on it.
+      Json_t retVal;
+      size_t used = 0;
+      try {
+         retVal = BsonSerializer::parse(document, size, used, flag);
+      }
+      catch (Exception& e) {
+         throw Exception(std::string(e.what()) + " in the document " + to_string(index) + " at location " + to_string(location));
+      }
+      if (used != size)
+         throw Exception("Document " + to_string(index) + " at location " + to_string(location) + " ends after " + to_string(used) + " of its " + to_string(size) + " bytes");
+      return retVal;
+   };
+}
+
+void BsonDocuments::parse(const char* data, size_t size, const Callback& callback, DecodingOption flag, unsigned threads) {
+   RecordBatches batches(frame, decoder(flag), BATCH_SIZE, threads);
+   batches.parse(data, size, callback);
+}
+
+std::vector<Json_t> BsonDocuments::parse(const char* data, size_t size, DecodingOption flag, unsigned threads) {
+   std::vector<Json_t> retVal;
+   parse(data, size, [&](const Json_t& document) { retVal.push_back(document); }, flag, threads);
+   return retVal;
+}
+
+void BsonDocuments::read(std::istream* in, const Callback& callback, DecodingOption flag, unsigned threads) {
+   RecordBatches batches(frame, decoder(flag), BATCH_SIZE, threads);
+   batches.read(in, callback);
+}
+
+std::vector<Json_t> BsonDocuments::read(std::istream* in, DecodingOption flag, unsigned threads) {
+   std::vector<Json_t> retVal;
+   read(in, [&](const Json_t& document) { retVal.push_back(document); }, flag, threads);
+   return retVal;
+}
+
+} } // namespace elladan::json
@@ -0,0 +1,46 @@
+/*
+ * BsonDocuments.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: daniel
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "../json.h"
+#include "../parallel.h"
+
+namespace elladan { namespace json {
+
+/**
+ * Concatenated bson documents (as written by mongodump) : every document starts with its int32 size.
+ * The input is cut in batches of documents, each batch is decoded over a pool of threads.
+ * Documents are always given back in input order.
+ */
+class BsonDocuments
+{
+public:
+    typedef std::function<void(const Json_t& document)> Callback;
+
+    // threads : number of threads to use, 0 for one per core.
+    static std::vector<Json_t> read(std::istream* in, DecodingOption flag, unsigned threads);
+    static void read(std::istream* in, const Callback& callback, DecodingOption flag, unsigned threads);
+    static std::vector<Json_t> parse(const char* data, size_t size, DecodingOption flag, unsigned threads);
+    static void parse(const char* data, size_t size, const Callback& callback, DecodingOption flag, unsigned threads);
+
+protected:
+    // Bytes read from the stream per thread before a batch is decoded.
+    static constexpr size_t BATCH_SIZE = 4 * 1024 * 1024;
+
+    // Cut the documents by their size, see RecordBatches::Frame.
+    static size_t frame(const char* data, size_t size, size_t limit, bool end, size_t offset, std::vector<const char*>& starts);
+    static RecordBatches::Decode decoder(DecodingOption flag);
+};
+
+} } // namespace elladan::json
@@ -6,6 +6,11 @@
  */
 
 #include "BsonSerializer.h"
+#include "JsonHandler.h"
+#include "JsonWriter.h"
+#include "MappedFile.h"
+#include "Number.h"
+#include "OutputSink.h"
 
 #include <elladan/Exception.h>
 #include <elladan/FlagSet.h>
@@ -14,6 +19,7 @@
 #include <stdio.h>
 #include <algorithm>
 #include <cstdint>
+#include <cstring>
 #include <memory>
 #include <utility>
 
@@ -46,16 +52,18 @@ constexpr char ELE_TYPE_INT64 = 0x12;
 //constexpr char ELE_TYPE_MIN = 0xFF;
 //constexpr char ELE_TYPE_MAX = 0x7F;
 
+// The document is kept whole until flush(), the sizes are written back once known.
 class BOStream {
 public :
-   std::ostream* _out;
+   OutputSink& _out;
    std::string _str;
 
-   BOStream(std::ostream* out)  : _out(out) {
+   BOStream(OutputSink& out)  : _out(out) {
       _str.reserve(1024);
    }
-   ~BOStream() {
-      _out->write(_str.c_str(), _str.size());
+   void flush() {
+      _out.write(_str.c_str(), _str.size());
+      _str.clear();
    }
 
    BOStream& operator << (char c){
@@ -137,17 +145,14 @@ protected:
    BOStream& _out;
 };
 
-inline void BsonSerializer::writeDoc(BOStream& out, const elladan::VMap<std::string, Json_t>& eleList, EncodingOption flag){
-   SizeMarker marker (out);
-   for (auto& ite : eleList) {
-      // print type
-      out << getBsonType(ite.second.get());
-      // print name
-      out << ite.first;
-      // print value
-      writeBson(out, ite.second.get(), flag);
-   }
+inline void BsonSerializer::writeElement(BOStream& out, const char* name, size_t size, const Json* ele, EncodingOption flag){
+   // print type
+   out << getBsonType(ele);
+   // print name
+   out.write(name, size);
    out << DOC_END;
+   // print value
+   writeBson(out, ele, flag);
 }
 
 void BsonSerializer::writeBson(BOStream& out, const Json* ele, EncodingOption flag) {
@@ -176,26 +181,26 @@ void BsonSerializer::writeBson(BOStream& out, const Json* ele, EncodingOption fl
 
       case JsonType::JSON_ARRAY:
       {
-         elladan::VMap<std::string, Json_t> eleList;
-         int i = 0;
-         for (Json_t ite : static_cast<const JsonArray*>(ele)->value)
-            eleList[to_string(i++)] = ite;
-
-         writeDoc(out, eleList, flag);
+         SizeMarker marker (out);
+         char name[Number::MAX_INT_SIZE];
+         int64_t i = 0;
+         for (const auto& ite : static_cast<const JsonArray*>(ele)->value)
+            writeElement(out, name, Number::formatInt(i++, name), ite.get(), flag);
+         out << DOC_END;
       } break;
 
       case JsonType::JSON_OBJECT:
-         if (flag.test(EncodingFlags::EF_JSON_SORT_KEY)) {
-            elladan::VMap<std::string, Json_t> eleList;
-            int i = 0;
-            for (Json_t ite : static_cast<const JsonArray*>(ele)->value)
-               eleList[to_string(i++)] = ite;
-            std::stable_sort(eleList.begin(), eleList.end());
-            writeDoc(out, eleList, flag);
-         }
+      {
+         SizeMarker marker (out);
+         const JsonObject* obj = static_cast<const JsonObject*>(ele);
+         if (flag.test(EncodingFlags::EF_JSON_SORT_KEY))
+            for (const JsonObject::Member* ite : obj->sortedMembers())
+               writeElement(out, ite->first.c_str(), ite->first.size(), ite->second.get(), flag);
          else
-            writeDoc(out, static_cast<const JsonObject*>(ele)->value, flag);
-         break;
+            for (const auto& ite : obj->value)
+               writeElement(out, ite.first.c_str(), ite.first.size(), ite.second.get(), flag);
+         out << DOC_END;
+      } break;
 
       case JsonType::JSON_BINARY:
       {
@@ -225,11 +230,17 @@ void BsonSerializer::writeBson(BOStream& out, const Json* ele, EncodingOption fl
 }
 
 void BsonSerializer::write(std::ostream* out, const Json* data, EncodingOption flag){
+   StreamSink sink(out);
+   write(sink, data, flag);
+}
+
+void BsonSerializer::write(OutputSink& out, const Json* data, EncodingOption flag){
    BOStream str(out);
    switch (data->getType()) {
       case JSON_ARRAY:
       case JSON_OBJECT:
          writeBson(str, data, flag);
+         str.flush();
          break;
 
       default:
@@ -238,44 +249,249 @@ void BsonSerializer::write(std::ostream* out, const Json* data, EncodingOption f
    }
 }
 
+///////////////////////////////////
+
+BsonWriter::BsonWriter(std::ostream* out, EncodingOption flag) :
+   _stream(new StreamSink(out)), _out(*_stream), _flags(flag), _hasKey(false) {
+   _buf.reserve(1024);
+}
+
+BsonWriter::BsonWriter(OutputSink& out, EncodingOption flag) :
+   _out(out), _flags(flag), _hasKey(false) {
+   _buf.reserve(1024);
+}
+
+// Same layout as writeElement() : type, name then value.
+void BsonWriter::element(char type) {
+   if (_stack.empty())
+      throw Exception("Bson require that root object is either an object or an array");
+
+   Level& level = _stack.back();
+   _buf.push_back(type);
+   if (level.isObject) {
+      if (!_hasKey)
+         throw Exception("Value without a key in an object");
+      _hasKey = false;
+      _buf += _key;
+   }
+   else {
+      char name[Number::MAX_INT_SIZE];
+      _buf.append(name, Number::formatInt(level.count, name));
+   }
+   _buf.push_back(DOC_END);
+   level.count++;
+}
+
+void BsonWriter::start(char type) {
+   if (!_stack.empty())
+      element(type);
+   _stack.push_back({_buf.size(), type == ELE_TYPE_OBJECT, 0});
+   _buf.append(sizeof(uint32_t), '\0');
+}
+
+void BsonWriter::end(bool isObject) {
+   if (_stack.empty() || _stack.back().isObject != isObject || _hasKey)
+      throw Exception("Unexpected end of document");
+
+   _buf.push_back(DOC_END);
+   uint32_t size = _buf.size() - _stack.back().sizePos;
+   _buf.replace(_stack.back().sizePos, sizeof(size), (const char*)&size, sizeof(size));
+   _stack.pop_back();
+
+   if (_stack.empty()) {
+      _out.write(_buf.c_str(), _buf.size());
+      _buf.clear();
+   }
+}
+
+void BsonWriter::onNull() {
+   element(ELE_TYPE_NULL);
+}
+void BsonWriter::onBool(bool value) {
+   element(ELE_TYPE_BOOL);
+   _buf.push_back((char) value);
+}
+void BsonWriter::onInt(int64_t value) {
+   element(ELE_TYPE_INT64);
+   _buf.append((const char*)&value, sizeof(value));
+}
+void BsonWriter::onDouble(double value) {
+   element(ELE_TYPE_DOUBLE);
+   _buf.append((const char*)&value, sizeof(value));
+}
+void BsonWriter::onString(const std::string& value) {
+   element(ELE_TYPE_UTF_STRING);
+   uint32_t size = value.size() + 1;
+   _buf.append((const char*)&size, sizeof(size));
+   _buf += value;
+   _buf.push_back(DOC_END);
+}
+void BsonWriter::onBinary(const Binary_t& value) {
+   element(ELE_TYPE_BIN);
+   uint32_t size = value ? value->size : 0;
+   _buf.append((const char*)&size, sizeof(size));
+   _buf.push_back((char) 0x02);
+   if (value)
+      _buf.append((const char*) value->data, value->size);
+}
+void BsonWriter::onUUID(const elladan::UUID& value) {
+   element(ELE_TYPE_BIN);
+   uint32_t size = value.getSize();
+   _buf.append((const char*)&size, sizeof(size));
+   _buf.push_back((char) 0x04);
+   _buf.append((const char*) value.getRaw(), size);
+}
+
+void BsonWriter::onKey(const std::string& key) {
+   if (_stack.empty() || !_stack.back().isObject || _hasKey)
+      throw Exception("Key " + key + " outside of an object");
+   _key = key;
+   _hasKey = true;
+}
+void BsonWriter::onStartObject() {
+   start(ELE_TYPE_OBJECT);
+}
+void BsonWriter::onEndObject() {
+   end(true);
+}
+void BsonWriter::onStartArray() {
+   start(ELE_TYPE_ARRAY);
+}
+void BsonWriter::onEndArray() {
+   end(false);
+}
+
 
 ///////////////////////////////////
 
 class BIStream {
 public :
    std::istream* _in;
+   DecodingOption flags;
+   // Type of each open container, kept to be reused from one document to the next.
+   std::string nesting;
+
+   BIStream(std::istream* in, DecodingOption flag) : _in(in), flags(flag), _begin(nullptr), _cur(nullptr), _end(nullptr) {}
+
+   // Read straight from memory, data must outlive the BIStream.
+   BIStream(const char* data, size_t size, DecodingOption flag) : _in(nullptr), flags(flag), _begin(data), _cur(data), _end(data + size) {}
 
-   BIStream(std::istream* in) : _in(in) {}
+   // Keep the memory read from, set when the binaries may point into it.
+   std::shared_ptr<void> owner;
 
+   // Bytes read so far from memory.
+   size_t pos() const {
+      return _cur - _begin;
+   }
+
+   // Throw when the input ends before val.
    template <typename T>
    int operator >> (T& val){
-      _in->read((char*)&val, sizeof(val));
-      return !_in->eof();
+      if (!_in) {
+         if ((size_t)(_end - _cur) < sizeof(val))
+            throwException("Unexpected EOF");
+         memcpy(&val, _cur, sizeof(val));
+         _cur += sizeof(val);
+         return 1;
+      }
+      if (!_in->read((char*)&val, sizeof(val)))
+         throwException("Unexpected EOF");
+      return 1;
    }
    int read(void* data, size_t size){
+      if (!_in) {
+         if ((size_t)(_end - _cur) < size)
+            return 0;
+         memcpy(data, _cur, size);
+         _cur += size;
+         return 1;
+      }
       _in->read((char*)data, size);
       return !_in->fail();
    }
-   int ignore(size_t size){
+   // Skip size bytes of memory, null if there are not that many.
+   const char* borrow(size_t size){
+      if (_in || (size_t)(_end - _cur) < size)
+         return nullptr;
+      const char* retVal = _cur;
+      _cur += size;
+      return retVal;
+   }
+   // Throw when the input ends before size bytes.
+   void ignore(size_t size){
+      if (!_in) {
+         if ((size_t)(_end - _cur) < size)
+            throwException("Unexpected EOF");
+         _cur += size;
+         return;
+      }
       _in->ignore(size);
-      return !_in->eof();
+      if ((size_t) _in->gcount() != size)
+         throwException("Unexpected EOF");
+   }
+
+   // Check the size of a document which size prefix was just read, against what is left in memory.
+   void checkSize(uint32_t size){
+      if (size < 5 || (!_in && size - sizeof(size) > (size_t)(_end - _cur)))
+         throwException("Invalid document size " + to_string(size));
+   }
+
+   // Enter a document, throw past the maximum depth.
+   void open(char type){
+      if (nesting.size() >= flags.getMaxDepth())
+         throwException("Maximum depth exceeded");
+      nesting.push_back(type);
    }
 
    void throwException(const std::string& what){
-      throw Exception(what + " at location " + to_string((int)_in->tellg()));
+      if (!_in)
+         throw Exception(what + " at location " + to_string(_cur - _begin));
+      // A failed stream can't tell where it is.
+      std::streamoff location = _in->tellg();
+      if (location < 0)
+         throw Exception(what + " at an unknown location");
+      throw Exception(what + " at location " + to_string(location));
    }
+
+protected:
+   const char* _begin;
+   const char* _cur;
+   const char* _end;
 };
 
 template <>
 int BIStream::operator >> <std::string>(std::string& str){
-   char c;
-   while (*this >> c) {
+   if (!_in) {
+      const char* nul = (const char*) memchr(_cur, '\0', _end - _cur);
+      if (!nul)
+         throw Exception("End of file while reading null terminated string");
+      str.append(_cur, nul);
+      _cur = nul + 1;
+      return str.size();
+   }
+
+   int c;
+   while ((c = _in->get()) != EOF) {
       if (!c) return str.size();
-      str.push_back(c);
+      str.push_back((char) c);
    }
    throw Exception("End of file while reading null terminated string");
 }
 
+// Binary pointing into the input, the input is kept as long as the binary.
+class BorrowedBinary : public Binary {
+public:
+   BorrowedBinary(const char* d, size_t s, const std::shared_ptr<void>& owner) :
+      Binary((void*) d, s), _owner(owner) {
+   }
+   ~BorrowedBinary() {
+      data = nullptr;
+   }
+
+protected:
+   std::shared_ptr<void> _owner;
+};
+
 inline void BsonSerializer::readName(BIStream& in, std::string& name){
    in >> name;
 }
@@ -285,82 +501,97 @@ inline void BsonSerializer::readRaw(BIStream& in, char* data, size_t size){
       in.throwException("End of file before getting end of data");
 }
 
-Json_t BsonSerializer::readBson(BIStream& in, char type){
-   switch (type) {
-      case ELE_TYPE_OBJECT:
-      {
-         uint32_t size = 0;
-         readRaw(in, (char*)&size, sizeof(size));
-
-         JsonObject_t obj = std::make_shared<JsonObject>();
-         char subType;
-         in >> subType;
-         while (subType != EOF && subType != DOC_END){
-            std::string name;
-            readName(in, name);
-            obj->value[name] = readBson(in, subType);
-            in >> subType;
-         }
+void BsonSerializer::parseBson(BIStream& in, char type, JsonHandler& handler){
+   // No recursion : the open containers are kept in in.nesting, the ones below `base` belong to the caller.
+   size_t base = in.nesting.size();
+   std::string name;
 
-         return obj;
-      }
-      case ELE_TYPE_ARRAY:
-      {
+   do {
+      if (type == ELE_TYPE_OBJECT || type == ELE_TYPE_ARRAY) {
          uint32_t size = 0;
          readRaw(in, (char*)&size, sizeof(size));
+         in.checkSize(size);
 
-         JsonArray_t obj = std::make_shared<JsonArray>();
+         in.open(type);
+         if (type == ELE_TYPE_OBJECT)
+            handler.onStartObject();
+         else
+            handler.onStartArray();
+      }
+      else
+         parseValue(in, type, handler);
 
+      // Get the type of the next element, closing the documents that ends here.
+      while (in.nesting.size() > base) {
          char subType;
          in >> subType;
-         while (subType != EOF && subType != DOC_END){
-            std::string name;
+         if (subType != DOC_END) {
+            name.clear();
             readName(in, name);
-            obj->value.push_back(readBson(in, subType));
-            in >> subType;
+            // The handler may reject the key (duplicate, ...), report it where it was found.
+            if (in.nesting.back() == ELE_TYPE_OBJECT) {
+               try {
+                  handler.onKey(name);
+               }
+               catch (Exception& e) {
+                  in.throwException(e.what());
+               }
+            }
+            type = subType;
+            break;
          }
 
-         return obj;
+         if (in.nesting.back() == ELE_TYPE_OBJECT)
+            handler.onEndObject();
+         else
+            handler.onEndArray();
+         in.nesting.pop_back();
       }
+   } while (in.nesting.size() > base);
+}
+
+void BsonSerializer::parseValue(BIStream& in, char type, JsonHandler& handler){
+   switch (type) {
       case ELE_TYPE_UTF_STRING:
       {
          uint32_t size = 0;
          readRaw(in, (char*)&size, sizeof(size));
-         JsonString_t obj = std::make_shared<JsonString>();
-         obj->value.reserve(size+1);
-         char val[257];
-         int curChar;
-         while (size > 0){
-            curChar = std::min(size, (uint32_t)256);
-            readRaw(in, val, size);
-            val[size] = 0;
-            obj->value.append(val);
-            size -= curChar;
-         }
-         if (val[curChar-1] != 0)
+         if (size == 0)
             in.throwException("String does not end with null char");
-         return obj;
-      }
+
+         std::string value;
+         value.resize(size);
+         readRaw(in, &value[0], size);
+         if (value.back() != 0)
+            in.throwException("String does not end with null char");
+         value.pop_back();
+         handler.onString(value);
+      } break;
+
       case ELE_TYPE_DOUBLE:
       {
          double val = 0;
          readRaw(in, (char*)&val, sizeof(val));
-         return std::make_shared<JsonDouble>(val);
-      }
+         handler.onDouble(val);
+      } break;
+
       case ELE_TYPE_INT64:
       {
          int64_t val = 0;
          readRaw(in, (char*)&val, sizeof(val));
-         return std::make_shared<JsonInt>(val);
-      }
+         handler.onInt(val);
+      } break;
+
       case ELE_TYPE_BOOL:
       {
          char val = 0;
          readRaw(in, &val, sizeof(val));
-         return std::make_shared<JsonBool>(val);
-      }
+         handler.onBool(val);
+      } break;
+
       case ELE_TYPE_NULL:
-         return std::make_shared<JsonNull>();
+         handler.onNull();
+         break;
 
       case ELE_TYPE_BIN:
       {
@@ -372,18 +603,27 @@ Json_t BsonSerializer::readBson(BIStream& in, char type){
 
          switch (subtype) {
             case 0x02: {
-               Binary_t bin = std::make_shared<Binary>(size);
-               readRaw(in, (char*)bin->data, bin->size);
-               return std::make_shared<JsonBinary>(bin);
+               Binary_t bin;
+               if (in.owner) {
+                  const char* data = in.borrow(size);
+                  if (!data)
+                     in.throwException("End of file before getting end of data");
+                  bin = std::make_shared<BorrowedBinary>(data, size, in.owner);
+               }
+               else {
+                  bin = std::make_shared<Binary>(size);
+                  readRaw(in, (char*)bin->data, bin->size);
+               }
+               handler.onBinary(bin);
             } break;
 
             case 0x04: {
-               JsonUUID_t uuid = std::make_shared<JsonUUID>();
-               if (size != uuid->value.getSize())
+               elladan::UUID uuid;
+               if (size != uuid.getSize())
                   in.throwException("Expected UUID, but size is wrong");
 
-               readRaw(in, (char*)uuid->value.getRaw(), size);
-               return uuid;
+               readRaw(in, (char*)uuid.getRaw(), size);
+               handler.onUUID(uuid);
             } break;
 
             default:
@@ -395,64 +635,102 @@ Json_t BsonSerializer::readBson(BIStream& in, char type){
       default:
          in.throwException("Unknown/Unsupported type " + std::to_string(type));
    }
-   return Json_t();
+}
+
+Json_t BsonSerializer::readBson(BIStream& in, char type){
+   JsonBuilder builder(in.flags);
+   parseBson(in, type, builder);
+   return builder.get();
 }
 
 
 Json_t BsonSerializer::read(std::istream* in, DecodingOption flag){
-   BIStream str(in);
+   BIStream str(in, flag);
    return readBson(str, ELE_TYPE_OBJECT);
 }
 
+Json_t BsonSerializer::parse(const char* data, size_t size, DecodingOption flag){
+   BIStream str(data, size, flag);
+   return readBson(str, ELE_TYPE_OBJECT);
+}
+
+Json_t BsonSerializer::parse(const char* data, size_t size, size_t& used, DecodingOption flag){
+   BIStream str(data, size, flag);
+   Json_t retVal = readBson(str, ELE_TYPE_OBJECT);
+   used = str.pos();
+   return retVal;
+}
+
+void BsonSerializer::read(std::istream* in, JsonHandler& handler, DecodingOption flag){
+   BIStream str(in, flag);
+   parseBson(str, ELE_TYPE_OBJECT, handler);
+}
+
+void BsonSerializer::parse(const char* data, size_t size, JsonHandler& handler, DecodingOption flag){
+   BIStream str(data, size, flag);
+   parseBson(str, ELE_TYPE_OBJECT, handler);
+}
 
 std::vector<Json_t> BsonSerializer::searchBson(BIStream& in, char type, int deepness, std::vector<std::string> parts){
    std::vector<Json_t> retVal;
-   switch (type) {
-      case ELE_TYPE_OBJECT:
-      case ELE_TYPE_ARRAY:
-      {
-         uint32_t size = 0;
-         readRaw(in, (char*)&size, sizeof(size));
+   if (type != ELE_TYPE_OBJECT && type != ELE_TYPE_ARRAY) {
+      skipBson(in, type);
+      return retVal;
+   }
 
-         JsonObject_t obj = std::make_shared<JsonObject>();
-         char subType;
-         in >> subType;
-         while (subType != EOF && subType != DOC_END){
-            std::string name;
-            readName(in, name);
+   // Path part of each document entered, kept here rather than on the call stack.
+   std::vector<size_t> levels;
+   std::string name;
+   char subType;
 
-            bool match;
-            bool inc = true;
+   do {
+      // Enter the document, its path part is deepness.
+      uint32_t size = 0;
+      readRaw(in, (char*)&size, sizeof(size));
+      in.checkSize(size);
 
-            if (parts[deepness] == "**") {
-               match = true;
-               inc = false;
-               deepness += (deepness + 1 < parts.size() && parts[deepness+1] == name);
-            }
-            else {
-               match = parts[deepness] == "*" || parts[deepness] == name;
-            }
+      in.open(type);
+      levels.push_back(deepness);
+
+      // Look at the elements until one is entered, closing the documents ended on the way.
+      type = 0;
+      while (!type && !levels.empty()) {
+         in >> subType;
+         if (subType == DOC_END) {
+            in.nesting.pop_back();
+            levels.pop_back();
+            continue;
+         }
 
-            if (match && deepness+1 == parts.size())
-               retVal.push_back(readBson(in, subType));
+         name.clear();
+         readName(in, name);
 
-            else if (match) {
-               auto subRet = searchBson(in, subType, deepness+inc, parts);
-               retVal.insert(retVal.end(), subRet.begin(), subRet.end());
-            }
+         size_t& part = levels.back();
+         bool match;
+         bool inc = true;
 
-            else
-               skipBson(in, subType);
+         if (parts[part] == "**") {
+            match = true;
+            inc = false;
+            part += (part + 1 < parts.size() && parts[part+1] == name);
+         }
+         else {
+            match = parts[part] == "*" || parts[part] == name;
+         }
 
-            in >> subType;
+         if (match && part+1 == parts.size())
+            retVal.push_back(readBson(in, subType));
+
+         else if (match && (subType == ELE_TYPE_OBJECT || subType == ELE_TYPE_ARRAY)) {
+            type = subType;
+            deepness = part + inc;
          }
 
-      } break;
+         else
+            skipBson(in, subType);
+      }
+   } while (type);
 
-      default:
-         skipBson(in, type);
-         break;
-   }
    return retVal;
 }
 
@@ -463,7 +741,8 @@ void BsonSerializer::skipBson(BIStream& in, char type){
       {
          uint32_t size = 0;
          readRaw(in, (char*)&size, sizeof(size));
-         in.ignore(size-4);
+         in.checkSize(size);
+         in.ignore(size - sizeof(size));
       } break;
       case ELE_TYPE_UTF_STRING:
       {
@@ -494,7 +773,21 @@ void BsonSerializer::skipBson(BIStream& in, char type){
 }
 
 std::vector<Json_t> BsonSerializer::extract(std::istream* in, DecodingOption flag, const std::string& path){
-   BIStream str(in);
+   BIStream str(in, flag);
+   return searchBson(str, ELE_TYPE_OBJECT, 1, tokenize(path, "/"));
+}
+
+Json_t BsonSerializer::parse(const std::shared_ptr<MappedFile>& file, DecodingOption flag){
+   BIStream str(file->data(), file->size(), flag);
+   if (flag.test(DecodingFlags::DF_BORROW_BINARY))
+      str.owner = file;
+   return readBson(str, ELE_TYPE_OBJECT);
+}
+
+std::vector<Json_t> BsonSerializer::extract(const std::shared_ptr<MappedFile>& file, DecodingOption flag, const std::string& path){
+   BIStream str(file->data(), file->size(), flag);
+   if (flag.test(DecodingFlags::DF_BORROW_BINARY))
+      str.owner = file;
    return searchBson(str, ELE_TYPE_OBJECT, 1, tokenize(path, "/"));
 }
 
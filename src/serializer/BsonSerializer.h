@@ -7,9 +7,9 @@
 
 #pragma once
 
-#include <elladan/VMap.h>
 #include <stddef.h>
 #include <iostream>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -18,23 +18,37 @@
 namespace elladan { namespace json {
 
 class BOStream;
+class OutputSink;
 class BIStream;
+class JsonHandler;
+class MappedFile;
 
 class BsonSerializer
 {
 public:
     static void write(std::ostream* out, const Json* data, EncodingOption flag);
+    static void write(OutputSink& out, const Json* data, EncodingOption flag);
     static Json_t read(std::istream* in, DecodingOption flag);
+    static Json_t parse(const char* data, size_t size, DecodingOption flag);
+    // Set used to the number of bytes the document was decoded from.
+    static Json_t parse(const char* data, size_t size, size_t& used, DecodingOption flag);
+    static void read(std::istream* in, JsonHandler& handler, DecodingOption flag);
+    static void parse(const char* data, size_t size, JsonHandler& handler, DecodingOption flag);
     static std::vector<Json_t> extract(std::istream* in, DecodingOption flag, const std::string& path);
+    // With DF_BORROW_BINARY, the binaries point into the file and keep it.
+    static Json_t parse(const std::shared_ptr<MappedFile>& file, DecodingOption flag);
+    static std::vector<Json_t> extract(const std::shared_ptr<MappedFile>& file, DecodingOption flag, const std::string& path);
 
 protected:
     static char getBsonType(const Json* ele);
     static void writeBson(BOStream& out, const Json* data, EncodingOption flag);
-    static inline void writeDoc(BOStream& out, const elladan::VMap<std::string, Json_t>& eleList, EncodingOption flag);
+    static inline void writeElement(BOStream& out, const char* name, size_t size, const Json* ele, EncodingOption flag);
 
     static inline void readName(BIStream& in, std::string& name);
     static inline void readRaw(BIStream& in, char* data, size_t size);
     static Json_t readBson(BIStream& in, char type);
+    static void parseBson(BIStream& in, char type, JsonHandler& handler);
+    static void parseValue(BIStream& in, char type, JsonHandler& handler);
 
     static std::vector<Json_t> searchBson(BIStream& in, char type, int deepness, std::vector<std::string> parts);
     static void skipBson(BIStream& in, char type);
@@ -0,0 +1,121 @@
+/*
+ * JsonBinding.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: daniel
+ */
+
+#include "JsonBinding.h"
+
+#include <elladan/Exception.h>
+
+namespace elladan { namespace json {
+
+void jsonBindInvalid(JsonType expected) {
+   static const char* const names[] = {
+      "JSON_NONE", "JSON_NULL", "JSON_BOOL", "JSON_INTEGER", "JSON_DOUBLE",
+      "JSON_STRING", "JSON_ARRAY", "JSON_OBJECT", "JSON_BINARY", "JSON_UUID",
+   };
+   throw Exception(std::string("Invalid format, expected ") + names[expected]);
+}
+
+bool JsonBindHandler::next(JsonBindTarget& out) {
+   // A skipped scalar ends the skip, anything inside a skipped container is ignored.
+   if (_skip) {
+      if (_skip == 1)
+         _skip = 0;
+      return false;
+   }
+
+   if (_stack.empty()) {
+      if (_done)
+         throw Exception("Only one value can be bound");
+      _done = true;
+      out = _root;
+   }
+   else if (_stack.back().isObject)
+      out = _pending;
+   else
+      _stack.back().target.ops->element(_stack.back().target.ptr, out);
+   return true;
+}
+
+void JsonBindHandler::onNull() {
+   JsonBindTarget target;
+   if (next(target))
+      target.ops->onNull(target.ptr);
+}
+void JsonBindHandler::onBool(bool value) {
+   JsonBindTarget target;
+   if (next(target))
+      target.ops->onBool(target.ptr, value);
+}
+void JsonBindHandler::onInt(int64_t value) {
+   JsonBindTarget target;
+   if (next(target))
+      target.ops->onInt(target.ptr, value);
+}
+void JsonBindHandler::onDouble(double value) {
+   JsonBindTarget target;
+   if (next(target))
+      target.ops->onDouble(target.ptr, value);
+}
+void JsonBindHandler::onString(const std::string& value) {
+   JsonBindTarget target;
+   if (next(target))
+      target.ops->onString(target.ptr, value);
+}
+void JsonBindHandler::onBinary(const Binary_t& value) {
+   JsonBindTarget target;
+   if (next(target))
+      target.ops->onBinary(target.ptr, value);
+}
+void JsonBindHandler::onUUID(const elladan::UUID& value) {
+   JsonBindTarget target;
+   if (next(target))
+      target.ops->onUUID(target.ptr, value);
+}
+
+// An unknown member is skipped, whatever its value.
+void JsonBindHandler::onKey(const std::string& key) {
+   if (_skip)
+      return;
+   JsonBindTarget& top = _stack.back().target;
+   if (!top.ops->member(top.ptr, key, _pending))
+      _skip = 1;
+}
+
+void JsonBindHandler::onStartObject() {
+   if (_skip) {
+      _skip++;
+      return;
+   }
+   JsonBindTarget target;
+   next(target);
+   target.ops->onStartObject(target.ptr);
+   _stack.push_back({target, true});
+}
+void JsonBindHandler::onEndObject() {
+   if (_skip) {
+      if (--_skip == 1)
+         _skip = 0;
+      return;
+   }
+   _stack.pop_back();
+}
+
+void JsonBindHandler::onStartArray() {
+   if (_skip) {
+      _skip++;
+      return;
+   }
+   JsonBindTarget target;
+   next(target);
+   target.ops->onStartArray(target.ptr);
+   _stack.push_back({target, false});
+}
+void JsonBindHandler::onEndArray() {
+   onEndObject();
+}
+
+} } // namespace elladan::json
@@ -0,0 +1,449 @@
+/*
+ * JsonBinding.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: daniel
+ */
+
+#pragma once
+
+#include <elladan/Exception.h>
+#include <elladan/UUID.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <array>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "../json.h"
+#include "JsonHandler.h"
+#include "JsonWriter.h"
+
+/**
+ * Describe the bound members of a struct, once, next to it (same namespace, after its definition):
+ *
+ *    struct Point { int64_t x; double y; std::string name; std::vector<Point> children; };
+ *    JSON_BIND(Point, JSON_FIELD(x), JSON_FIELD(y), JSON_FIELD_AS("label", name), JSON_FIELD(children))
+ *
+ * JsonBinding then fills the struct from the parser events and writes it from its members, no tree is built.
+ * Bound members may be bool, integers, enums, floating points, std::string, Binary_t, elladan::UUID,
+ * std::vector of those or other bound structs.
+ */
+#define JSON_BIND(Type, ...) \
+    constexpr auto jsonFields(const Type*) { \
+        typedef Type JsonBound; \
+        return std::make_tuple(__VA_ARGS__); \
+    }
+#define JSON_FIELD(member) elladan::json::jsonField(#member, &JsonBound::member)
+#define JSON_FIELD_AS(name, member) elladan::json::jsonField(name, &JsonBound::member)
+
+namespace elladan { namespace json {
+
+template <typename C, typename M>
+struct JsonField {
+    const char* name;
+    M C::* member;
+};
+
+template <typename C, typename M>
+constexpr JsonField<C, M> jsonField(const char* name, M C::* member) {
+    return {name, member};
+}
+
+///////////////////////////////////
+// Compile time perfect hash of the keys.
+
+constexpr size_t jsonKeyLength(const char* key) {
+    size_t len = 0;
+    while (key[len])
+        len++;
+    return len;
+}
+
+constexpr bool jsonKeyEqual(const char* a, const char* b) {
+    while (*a && *a == *b) {
+        a++;
+        b++;
+    }
+    return *a == *b;
+}
+
+// FNV-1a, seeded.
+constexpr uint32_t jsonKeyHash(const char* key, size_t len, uint32_t seed) {
+    uint32_t h = 2166136261u ^ (seed * 0x9E3779B9u);
+    for (size_t i = 0; i < len; i++) {
+        h ^= (uint8_t) key[i];
+        h *= 16777619u;
+    }
+    return h ^ (h >> 15);
+}
+
+template <size_t N>
+struct JsonKeyNames {
+    const char* name[N ? N : 1];
+};
+
+// At least 4 slots per key, a seed is quickly found.
+constexpr size_t jsonKeySlots(size_t n) {
+    size_t size = 1;
+    while (size < 4 * n)
+        size *= 2;
+    return size;
+}
+
+template <size_t SIZE>
+struct JsonKeyTable {
+    uint32_t seed;
+    int16_t slot[SIZE];     // Index of the key hashed there, -1 if none.
+};
+
+// Look for a seed that sends every key to its own slot.
+template <size_t SIZE, size_t N>
+constexpr JsonKeyTable<SIZE> jsonKeyTable(const JsonKeyNames<N>& names) {
+    for (size_t i = 0; i < N; i++) {
+        for (size_t j = i + 1; j < N; j++) {
+            if (jsonKeyEqual(names.name[i], names.name[j]))
+                throw Exception("Key bound twice");
+        }
+    }
+
+    for (uint32_t seed = 0; seed < (1u << 16); seed++) {
+        JsonKeyTable<SIZE> table = {seed, {}};
+        for (size_t s = 0; s < SIZE; s++)
+            table.slot[s] = -1;
+
+        bool found = true;
+        for (size_t i = 0; found && i < N; i++) {
+            size_t s = jsonKeyHash(names.name[i], jsonKeyLength(names.name[i]), seed) & (SIZE - 1);
+            found = table.slot[s] < 0;
+            table.slot[s] = i;
+        }
+        if (found)
+            return table;
+    }
+    throw Exception("No perfect hash for the bound keys");
+}
+
+///////////////////////////////////
+// Type erased access to a bound value.
+
+struct JsonBindOps;
+
+struct JsonBindTarget {
+    void* ptr;
+    const JsonBindOps* ops;
+};
+
+struct JsonBindOps {
+    void (*onNull)(void*);
+    void (*onBool)(void*, bool);
+    void (*onInt)(void*, int64_t);
+    void (*onDouble)(void*, double);
+    void (*onString)(void*, const std::string&);
+    void (*onBinary)(void*, const Binary_t&);
+    void (*onUUID)(void*, const elladan::UUID&);
+    void (*onStartObject)(void*);
+    void (*onStartArray)(void*);
+    // Target of the member named key, false for an unknown key.
+    bool (*member)(void*, const std::string& key, JsonBindTarget& out);
+    // Target of a new element.
+    void (*element)(void*, JsonBindTarget& out);
+    void (*write)(const void*, JsonHandler&);
+};
+
+template <typename M, typename Enable = void>
+struct JsonBind;
+
+template <typename M>
+const JsonBindOps* jsonBindOps() {
+    typedef JsonBind<M> B;
+    static const JsonBindOps ops = {
+        B::onNull, B::onBool, B::onInt, B::onDouble, B::onString, B::onBinary, B::onUUID,
+        B::onStartObject, B::onStartArray, B::member, B::element, B::write,
+    };
+    return &ops;
+}
+
+// Throw the type error of a member bound to `expected`, named like in the fromJson() errors.
+void jsonBindInvalid(JsonType expected);
+
+// Every event is a type error, the bound types override the ones they accept.
+template <typename Derived>
+struct JsonBindBase {
+    static void invalid() {
+        jsonBindInvalid(Derived::TYPE);
+    }
+
+    static void onNull(void*)                               { invalid(); }
+    static void onBool(void*, bool)                         { invalid(); }
+    static void onInt(void*, int64_t)                       { invalid(); }
+    static void onDouble(void*, double)                     { invalid(); }
+    static void onString(void*, const std::string&)         { invalid(); }
+    static void onBinary(void*, const Binary_t&)            { invalid(); }
+    static void onUUID(void*, const elladan::UUID&)         { invalid(); }
+    static void onStartObject(void*)                        { invalid(); }
+    static void onStartArray(void*)                         { invalid(); }
+    static bool member(void*, const std::string&, JsonBindTarget&) { invalid(); return false; }
+    static void element(void*, JsonBindTarget&)             { invalid(); }
+};
+
+template <>
+struct JsonBind<bool> : JsonBindBase<JsonBind<bool>> {
+    static constexpr JsonType TYPE = JSON_BOOL;
+    static void onBool(void* p, bool value)                 { *static_cast<bool*>(p) = value; }
+    static void write(const void* p, JsonHandler& out)      { out.onBool(*static_cast<const bool*>(p)); }
+};
+
+// Json integers are int64_t, the bound integers must hold them and be held by them.
+template <typename M>
+struct JsonBindInt {
+    static bool fits(int64_t value) {
+        if (std::is_signed<M>::value)
+            return value >= (int64_t) std::numeric_limits<M>::min() && value <= (int64_t) std::numeric_limits<M>::max();
+        return value >= 0 && (uint64_t) value <= (uint64_t) std::numeric_limits<M>::max();
+    }
+    static int64_t read(int64_t value) {
+        if (!fits(value))
+            throw Exception("Invalid format, " + std::to_string(value) + " out of range");
+        return value;
+    }
+    static int64_t write(M value) {
+        if (!std::is_signed<M>::value && (uint64_t) value > (uint64_t) std::numeric_limits<int64_t>::max())
+            throw Exception("Invalid format, " + std::to_string(value) + " out of range");
+        return (int64_t) value;
+    }
+};
+
+template <typename M>
+struct JsonBind<M, typename std::enable_if<std::is_integral<M>::value && !std::is_same<M, bool>::value>::type> :
+    JsonBindBase<JsonBind<M>> {
+    static constexpr JsonType TYPE = JSON_INTEGER;
+    static void onInt(void* p, int64_t value)               { *static_cast<M*>(p) = (M) JsonBindInt<M>::read(value); }
+    static void write(const void* p, JsonHandler& out)      { out.onInt(JsonBindInt<M>::write(*static_cast<const M*>(p))); }
+};
+
+template <typename M>
+struct JsonBind<M, typename std::enable_if<std::is_enum<M>::value>::type> : JsonBindBase<JsonBind<M>> {
+    typedef typename std::underlying_type<M>::type U;
+    static constexpr JsonType TYPE = JSON_INTEGER;
+    static void onInt(void* p, int64_t value)               { *static_cast<M*>(p) = (M) JsonBindInt<U>::read(value); }
+    static void write(const void* p, JsonHandler& out)      { out.onInt(JsonBindInt<U>::write((U) *static_cast<const M*>(p))); }
+};
+
+// An integer is taken for a floating point: json writes 2.0 as 2 in many places.
+template <typename M>
+struct JsonBind<M, typename std::enable_if<std::is_floating_point<M>::value>::type> : JsonBindBase<JsonBind<M>> {
+    static constexpr JsonType TYPE = JSON_DOUBLE;
+    static void onInt(void* p, int64_t value)               { *static_cast<M*>(p) = (M) value; }
+    static void onDouble(void* p, double value)             { *static_cast<M*>(p) = (M) value; }
+    static void write(const void* p, JsonHandler& out)      { out.onDouble((double) *static_cast<const M*>(p)); }
+};
+
+template <>
+struct JsonBind<std::string> : JsonBindBase<JsonBind<std::string>> {
+    static constexpr JsonType TYPE = JSON_STRING;
+    static void onString(void* p, const std::string& value) { *static_cast<std::string*>(p) = value; }
+    static void write(const void* p, JsonHandler& out)      { out.onString(*static_cast<const std::string*>(p)); }
+};
+
+// As fromJson(), a string is read as the hex of the binary.
+template <>
+struct JsonBind<Binary_t> : JsonBindBase<JsonBind<Binary_t>> {
+    static constexpr JsonType TYPE = JSON_BINARY;
+    static void onBinary(void* p, const Binary_t& value)    { *static_cast<Binary_t*>(p) = value; }
+    static void onString(void* p, const std::string& value) { *static_cast<Binary_t*>(p) = std::make_shared<Binary>(value); }
+    static void write(const void* p, JsonHandler& out)      { out.onBinary(*static_cast<const Binary_t*>(p)); }
+};
+
+template <>
+struct JsonBind<elladan::UUID> : JsonBindBase<JsonBind<elladan::UUID>> {
+    static constexpr JsonType TYPE = JSON_UUID;
+    static void onUUID(void* p, const elladan::UUID& value) { *static_cast<elladan::UUID*>(p) = value; }
+    static void onString(void* p, const std::string& value) { *static_cast<elladan::UUID*>(p) = elladan::UUID::fromString(value); }
+    static void write(const void* p, JsonHandler& out)      { out.onUUID(*static_cast<const elladan::UUID*>(p)); }
+};
+
+template <typename E>
+struct JsonBind<std::vector<E>> : JsonBindBase<JsonBind<std::vector<E>>> {
+    static constexpr JsonType TYPE = JSON_ARRAY;
+
+    static void onStartArray(void* p) {
+        static_cast<std::vector<E>*>(p)->clear();
+    }
+    static void element(void* p, JsonBindTarget& out) {
+        std::vector<E>* vec = static_cast<std::vector<E>*>(p);
+        vec->emplace_back();
+        out = {&vec->back(), jsonBindOps<E>()};
+    }
+    static void write(const void* p, JsonHandler& out) {
+        out.onStartArray();
+        for (const E& ele : *static_cast<const std::vector<E>*>(p))
+            JsonBind<E>::write(&ele, out);
+        out.onEndArray();
+    }
+};
+
+// Structs described by JSON_BIND, found through argument dependent lookup.
+template <typename T>
+struct JsonBind<T, decltype((void) jsonFields((const T*) nullptr))> : JsonBindBase<JsonBind<T>> {
+    static constexpr JsonType TYPE = JSON_OBJECT;
+    typedef decltype(jsonFields((const T*) nullptr)) Fields;
+    static constexpr size_t COUNT = std::tuple_size<Fields>::value;
+    static constexpr size_t SLOTS = jsonKeySlots(COUNT);
+    typedef JsonBindTarget (*Target)(void*);
+
+    static void onStartObject(void*) {
+    }
+
+    static bool member(void* p, const std::string& key, JsonBindTarget& out) {
+        static constexpr Fields fields = jsonFields((const T*) nullptr);
+        static constexpr JsonKeyNames<COUNT> names = keyNames(fields, std::make_index_sequence<COUNT>());
+        static constexpr JsonKeyTable<SLOTS> table = jsonKeyTable<SLOTS>(names);
+        static const std::array<Target, COUNT> targets = makeTargets(std::make_index_sequence<COUNT>());
+
+        int slot = table.slot[jsonKeyHash(key.data(), key.size(), table.seed) & (SLOTS - 1)];
+        if (slot < 0 || key != names.name[slot])
+            return false;
+        out = targets[slot](p);
+        return true;
+    }
+
+    static void write(const void* p, JsonHandler& out) {
+        out.onStartObject();
+        writeFields(*static_cast<const T*>(p), out, std::make_index_sequence<COUNT>());
+        out.onEndObject();
+    }
+
+protected:
+    template <size_t... I>
+    static constexpr JsonKeyNames<COUNT> keyNames(const Fields& fields, std::index_sequence<I...>) {
+        return {{std::get<I>(fields).name...}};
+    }
+
+    template <size_t I>
+    static JsonBindTarget target(void* p) {
+        auto& member = static_cast<T*>(p)->*(std::get<I>(jsonFields((const T*) nullptr)).member);
+        return {&member, jsonBindOps<typename std::decay<decltype(member)>::type>()};
+    }
+
+    template <size_t... I>
+    static std::array<Target, COUNT> makeTargets(std::index_sequence<I...>) {
+        return {{&target<I>...}};
+    }
+
+    template <size_t... I>
+    static void writeFields(const T& value, JsonHandler& out, std::index_sequence<I...>) {
+        static const Fields fields = jsonFields((const T*) nullptr);
+        static const std::array<std::string, COUNT> keys = {{std::get<I>(fields).name...}};
+        using expand = int[];
+        (void) expand{0, (writeField(value, std::get<I>(fields), keys[I], out), 0)...};
+    }
+
+    template <typename M>
+    static void writeField(const T& value, const JsonField<T, M>& field, const std::string& key, JsonHandler& out) {
+        out.onKey(key);
+        JsonBind<M>::write(&(value.*field.member), out);
+    }
+};
+
+///////////////////////////////////
+
+/**
+ * Fill a bound value from the events, unknown members are skipped.
+ * The value is not cleared first : a member missing from the document keeps its value.
+ */
+class JsonBindHandler : public JsonHandler
+{
+public:
+    template <typename T>
+    JsonBindHandler(T& value) : _root{&value, jsonBindOps<T>()}, _pending{nullptr, nullptr}, _skip(0), _done(false) {}
+
+    void onNull();
+    void onBool(bool value);
+    void onInt(int64_t value);
+    void onDouble(double value);
+    void onString(const std::string& value);
+    void onBinary(const Binary_t& value);
+    void onUUID(const elladan::UUID& value);
+
+    void onKey(const std::string& key);
+    void onStartObject();
+    void onEndObject();
+    void onStartArray();
+    void onEndArray();
+
+protected:
+    // Target of the next value, false if it is skipped.
+    bool next(JsonBindTarget& out);
+
+    struct Level {
+        JsonBindTarget target;
+        bool isObject;
+    };
+
+    JsonBindTarget _root;
+    JsonBindTarget _pending;    // Member named by the last key.
+    std::vector<Level> _stack;  // Open objects and arrays.
+    size_t _skip;                       // Depth in a skipped value, 1 while waiting for it.
+    bool _done;
+};
+
+/**
+ * Read and write C++ values described by JSON_BIND straight from and to the serializers, without a tree.
+ * The root of a bson document is an object : bind it to a struct.
+ *
+ *    Point pt;
+ *    JsonBinding::parse(data, size, pt, DecodingOption(), StreamFormat::JSON);
+ *    JsonBinding::write(&out, pt, EncodingOption(), StreamFormat::BSON);
+ */
+class JsonBinding
+{
+public:
+    template <typename T>
+    static void read(std::istream* in, T& value, DecodingOption flag, StreamFormat format) {
+        JsonBindHandler handler(value);
+        Json::read(in, handler, flag, format);
+    }
+
+    template <typename T>
+    static void parse(const char* data, size_t size, T& value, DecodingOption flag, StreamFormat format) {
+        JsonBindHandler handler(value);
+        Json::parse(data, size, handler, flag, format);
+    }
+
+    template <typename T>
+    static void parse(const std::string& data, T& value, DecodingOption flag, StreamFormat format) {
+        parse(data.data(), data.size(), value, flag, format);
+    }
+
+    // Report the value as events.
+    template <typename T>
+    static void emit(const T& value, JsonHandler& handler) {
+        JsonBind<T>::write(&value, handler);
+    }
+
+    // Same output as Json::write() for the same document, EF_JSON_SORT_KEY aside.
+    template <typename T>
+    static void write(std::ostream* out, const T& value, EncodingOption flag, StreamFormat format) {
+        switch (format) {
+            case StreamFormat::JSON: {
+                JsonWriter writer(out, flag);
+                emit(value, writer);
+            } break;
+            case StreamFormat::BSON: {
+                BsonWriter writer(out, flag);
+                emit(value, writer);
+            } break;
+            default:
+                throw Exception("Unknown stream format");
+        }
+    }
+};
+
+} } // namespace elladan::json
@@ -0,0 +1,476 @@
+/*
+ * JsonDocument.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: daniel
+ */
+
+#include "JsonDocument.h"
+
+#include <elladan/Exception.h>
+#include <elladan/FlagSet.h>
+#include <elladan/Stringify.h>
+#include <cctype>
+#include <cstring>
+#include <memory>
+#include <sstream>
+#include <unordered_map>
+
+#include "JsonHandler.h"
+#include "JsonSerializer.h"
+#include "JsonStream.h"
+#include "StructuralIndex.h"
+
+namespace elladan { namespace json {
+
+JsonDocument::JsonDocument(std::istream* in, DecodingOption flag) : _flags(flag) {
+   std::ostringstream str;
+   str << in->rdbuf();
+   _owned = str.str();
+   _data = _owned.data();
+   _size = _owned.size();
+   build();
+}
+
+JsonDocument::JsonDocument(const char* data, size_t size, DecodingOption flag) :
+   _data(data), _size(size), _flags(flag) {
+   build();
+}
+
+/**
+ * Record the tape out of the structural index, checking the structure only.
+ * On error, the sequential parser is run to report it at the right position.
+ */
+void JsonDocument::build() {
+   if (_flags.test(DecodingFlags::DF_IGNORE_COMMENT) || _flags.test(DecodingFlags::DF_ALLOW_COMMA_ERR))
+      throw Exception("JsonDocument does not support DF_IGNORE_COMMENT nor DF_ALLOW_COMMA_ERR");
+
+   std::vector<uint32_t> index;
+   if (!StructuralIndex::build(_data, _size, index))
+      throw Exception("Document too large to be indexed");
+
+   enum State {
+      ST_VALUE,
+      ST_KEY,
+      ST_NEXT,
+   };
+
+   std::vector<uint32_t> open;   // Tape position of the open containers.
+   // Tape position of the elements of the open containers, moved to _children when their container closes.
+   std::vector<uint32_t> pending;
+   const uint32_t* cur = index.data();
+   const uint32_t* end = cur + index.size();
+   State state = ST_VALUE;
+   bool valid = true;
+
+   _tape.reserve(index.size());
+   while (valid && cur != end) {
+      const char* p = _data + *cur++;
+
+      if (state == ST_NEXT) {
+         size_t top = open.back();
+         char close = isObject(top) ? '}' : ']';
+         _tape[top].size++;
+
+         if (*p == ',') {
+            state = isObject(top) ? ST_KEY : ST_VALUE;
+            // A trailing comma is accepted, as by the sequential parser.
+            if (cur == end || _data[*cur] != close)
+               continue;
+            p = _data + *cur++;
+         }
+         if (*p != close) {
+            valid = false;
+            break;
+         }
+
+         _tape[top].next = _tape.size();
+         endContainer(top, pending);
+         open.pop_back();
+         state = ST_NEXT;
+         if (open.empty())
+            break;
+         continue;
+      }
+
+      if (state == ST_KEY) {
+         // The key, its closing quote and ':'.
+         if (*p != '"' || end - cur < 2 || _data[cur[0]] != '"' || _data[cur[1]] != ':') {
+            valid = false;
+            break;
+         }
+         pending.push_back(_tape.size());
+         _tape.push_back({*(cur - 1), (uint32_t) _tape.size() + 1, cur[0] - *(cur - 1) + 1, 0});
+         cur += 2;
+         state = ST_VALUE;
+         continue;
+      }
+
+      // The members of an object are found by their key.
+      if (!open.empty() && !isObject(open.back()))
+         pending.push_back(_tape.size());
+
+      switch (*p) {
+         case '{':
+         case '[':
+            if (open.size() >= _flags.getMaxDepth()) {
+               valid = false;
+               break;
+            }
+            open.push_back(_tape.size());
+            // Until it is closed, where its elements start in pending.
+            _tape.push_back({*(cur - 1), 0, 0, (uint32_t) pending.size()});
+
+            // Empty container.
+            if (cur != end && _data[*cur] == (*p == '{' ? '}' : ']')) {
+               cur++;
+               _tape.back().next = _tape.size();
+               endContainer(open.back(), pending);
+               open.pop_back();
+               state = ST_NEXT;
+            }
+            else
+               state = *p == '{' ? ST_KEY : ST_VALUE;
+            break;
+
+         case '"':
+            if (cur == end || _data[*cur] != '"') {
+               valid = false;
+               break;
+            }
+            _tape.push_back({*(cur - 1), (uint32_t) _tape.size() + 1, *cur - *(cur - 1) + 1, 0});
+            cur++;
+            state = ST_NEXT;
+            break;
+
+         case '}':
+         case ']':
+         case ',':
+         case ':':
+            valid = false;
+            break;
+
+         default: {
+            // The word must be followed by a white space or a structural character, anything may follow the root.
+            const char* lim = _data + (cur == end ? _size : *cur);
+            const char* word = p;
+            while (p < lim && isWordChar(*p))
+               p++;
+            if (p == word || (p < lim && !std::isspace(*p) && !open.empty())) {
+               valid = false;
+               break;
+            }
+            _tape.push_back({*(cur - 1), (uint32_t) _tape.size() + 1, (uint32_t) (p - word), 0});
+            state = ST_NEXT;
+         } break;
+      }
+
+      // A root value is complete.
+      if (state == ST_NEXT && open.empty())
+         break;
+   }
+
+   if (valid && open.empty() && (state == ST_NEXT || _tape.empty())) {
+      // The index has about twice as many entries as the tape.
+      _tape.shrink_to_fit();
+      _children.shrink_to_fit();
+      return;
+   }
+
+   // Let the sequential parser find the error.
+   _tape.clear();
+   _children.clear();
+   SIStream in(_data, _size, _flags);
+   JsonSerializer::readRoot(in);
+   throw Exception("Could not record the document");
+}
+
+void JsonDocument::throwAt(size_t offset, const std::string& err) const {
+   SIStream in(_data, _size, _flags);
+   in.skip(_data + offset + 1);
+   in.throwErr(err);
+}
+
+// The container at pos is complete, its elements go to _children.
+void JsonDocument::endContainer(size_t pos, std::vector<uint32_t>& pending) {
+   size_t base = _tape[pos].children;
+   _tape[pos].children = _children.size();
+   _children.insert(_children.end(), pending.begin() + base, pending.end());
+   pending.resize(base);
+}
+
+// Decode the string at pos.
+std::string JsonDocument::text(size_t pos) const {
+   const Entry& ele = _tape[pos];
+   const char* begin = _data + ele.offset + 1;
+   size_t len = ele.size - 2;
+   if (!memchr(begin, '\\', len) && !memchr(begin, '\0', len))
+      return std::string(begin, len);
+
+   SIStream in(_data, _size, _flags);
+   in.skip(begin);
+   std::string retVal;
+   JsonSerializer::jsonToString(in, retVal);
+   return retVal;
+}
+
+bool JsonDocument::keyIs(size_t pos, const std::string& key) const {
+   const Entry& ele = _tape[pos];
+   if (!memchr(_data + ele.offset + 1, '\\', ele.size - 2))
+      return ele.size - 2 == key.size() && !memcmp(_data + ele.offset + 1, key.data(), key.size());
+   return text(pos) == key;
+}
+
+// Report the value at pos, no recursion : the open containers are kept on the side.
+void JsonDocument::emit(size_t pos, JsonHandler& handler) const {
+   struct Open {
+      size_t next;
+      bool isObject;
+      bool atKey;
+   };
+   std::vector<Open> open;
+   size_t end = _tape[pos].next;
+
+   for (size_t i = pos; i < end; i++) {
+      while (!open.empty() && open.back().next == i) {
+         if (open.back().isObject)
+            handler.onEndObject();
+         else
+            handler.onEndArray();
+         open.pop_back();
+      }
+
+      // Keys and values alternate in an object.
+      if (!open.empty() && open.back().isObject) {
+         open.back().atKey = !open.back().atKey;
+         if (open.back().atKey) {
+            // The handler may reject the key (duplicate, ...), report it where it was found.
+            std::string key = text(i);
+            try {
+               handler.onKey(key);
+            }
+            catch (Exception& e) {
+               throwAt(_tape[i].offset + _tape[i].size - 1, e.what());
+            }
+            continue;
+         }
+      }
+
+      const Entry& ele = _tape[i];
+      switch (_data[ele.offset]) {
+         case '{':
+            handler.onStartObject();
+            open.push_back({ele.next, true, false});
+            break;
+
+         case '[':
+            handler.onStartArray();
+            open.push_back({ele.next, false, false});
+            break;
+
+         case '"':
+            handler.onString(text(i));
+            break;
+
+         default:
+            if (!JsonSerializer::readWord(_data + ele.offset, ele.size, _flags, handler))
+               throwAt(ele.offset + ele.size - 1, "Could not identity type of " + std::string(_data + ele.offset, ele.size));
+            break;
+      }
+   }
+
+   while (!open.empty()) {
+      if (open.back().isObject)
+         handler.onEndObject();
+      else
+         handler.onEndArray();
+      open.pop_back();
+   }
+}
+
+JsonDocument::Value JsonDocument::root() const {
+   return Value(this, 0);
+}
+
+std::vector<Json_t> JsonDocument::getChild(const std::string& path) const {
+   return root().getChild(path);
+}
+
+// Same walk as Json::getChild(), over the tape. The containers entered are kept on the side, not on the call stack.
+void JsonDocument::getChild(size_t pos, const std::vector<std::string>& parts, std::vector<Json_t>& retVal) const {
+   struct Level {
+      size_t pos;
+      size_t deepness;
+      size_t idx;    // Next element or member.
+      // A repeated key keeps the place of the first one and the last value, as in the tree.
+      std::unordered_map<std::string, size_t> last;
+   };
+   std::vector<Level> open;
+   size_t deepness = 1;
+
+   while (1) {
+      // Enter or take the value at pos.
+      if (deepness >= parts.size())
+         // We are past the path parts : this is the one we are looking for.
+         retVal.push_back(Value(this, pos).get());
+      else if (isObject(pos) || isArray(pos)) {
+         open.push_back({pos, deepness, 0, {}});
+         if (isObject(pos)) {
+            for (size_t i = 0; i < _tape[pos].size; i++) {
+               size_t key = child(pos, i);
+               open.back().last[text(key)] = key + 1;
+            }
+         }
+      }
+
+      // Next matching value, closing the containers done on the way.
+      bool found = false;
+      while (!found && !open.empty()) {
+         Level& level = open.back();
+         if (level.idx == _tape[level.pos].size) {
+            open.pop_back();
+            continue;
+         }
+
+         size_t i = level.idx++;
+         std::string name;
+         if (isObject(level.pos)) {
+            name = text(child(level.pos, i));
+            auto ite = level.last.find(name);
+            if (ite == level.last.end())
+               continue;
+            pos = ite->second;
+            level.last.erase(ite);
+         }
+         else {
+            name = std::to_string(i);
+            pos = child(level.pos, i);
+         }
+
+         size_t inc = 1;
+         if (parts[level.deepness] == "**") {
+            found = true;
+            inc = 2 * (level.deepness + 1 < parts.size() && parts[level.deepness + 1] == name);
+         }
+         else
+            found = parts[level.deepness] == "*" || parts[level.deepness] == name;
+         deepness = level.deepness + inc;
+      }
+      if (!found)
+         return;
+   }
+}
+
+///////////////////////////////////
+
+JsonType JsonDocument::Value::getType() const {
+   if (_doc->_tape.empty())
+      return JSON_NONE;
+
+   switch (_doc->_data[_doc->_tape[_pos].offset]) {
+      case '{': return JSON_OBJECT;
+      case '[': return JSON_ARRAY;
+      case '"': return JSON_STRING;
+      default:  return get()->getType();
+   }
+}
+
+size_t JsonDocument::Value::size() const {
+   if (_doc->_tape.empty() || (!_doc->isObject(_pos) && !_doc->isArray(_pos)))
+      return 0;
+   return _doc->_tape[_pos].size;
+}
+
+JsonDocument::Value JsonDocument::Value::operator[](const std::string& key) const {
+   if (_doc->_tape.empty() || !_doc->isObject(_pos))
+      throw Exception("Not an object, could not get " + key);
+
+   size_t found = 0;
+   size_t child = _pos + 1;
+   for (size_t i = 0; i < _doc->_tape[_pos].size; i++) {
+      if (_doc->keyIs(child, key))
+         found = child + 1;
+      child = _doc->_tape[child + 1].next;
+   }
+   if (!found)
+      throw Exception("No member " + key);
+   return Value(_doc, found);
+}
+
+JsonDocument::Value JsonDocument::Value::operator[](size_t idx) const {
+   if (_doc->_tape.empty() || (!_doc->isObject(_pos) && !_doc->isArray(_pos)))
+      throw Exception("Not an object nor an array, could not get " + std::to_string(idx));
+
+   size_t child = _doc->child(_pos, idx);
+   return Value(_doc, _doc->isObject(_pos) ? child + 1 : child);
+}
+
+std::string JsonDocument::Value::key(size_t idx) const {
+   if (_doc->_tape.empty() || !_doc->isObject(_pos))
+      throw Exception("Not an object, no key");
+   return _doc->text(_doc->child(_pos, idx));
+}
+
+JsonDocument::Iterator JsonDocument::Value::begin() const {
+   if (_doc->_tape.empty())
+      return Iterator(_doc, 0, false);
+   bool object = _doc->isObject(_pos);
+   if (!object && !_doc->isArray(_pos))
+      return end();
+   return Iterator(_doc, _pos + 1, object);
+}
+
+JsonDocument::Iterator JsonDocument::Value::end() const {
+   if (_doc->_tape.empty())
+      return Iterator(_doc, 0, false);
+   return Iterator(_doc, _doc->_tape[_pos].next, _doc->isObject(_pos));
+}
+
+Json_t JsonDocument::Value::get() const {
+   if (_doc->_tape.empty())
+      return std::make_shared<Json>();
+
+   JsonBuilder builder(_doc->_flags);
+   _doc->emit(_pos, builder);
+   return builder.get();
+}
+
+JsonObject_t JsonDocument::Value::toObject() const {
+   if (_doc->_tape.empty() || !_doc->isObject(_pos))
+      throw Exception("Not an object");
+   return std::static_pointer_cast<JsonObject>(get());
+}
+
+JsonArray_t JsonDocument::Value::toArray() const {
+   if (_doc->_tape.empty() || !_doc->isArray(_pos))
+      throw Exception("Not an array");
+   return std::static_pointer_cast<JsonArray>(get());
+}
+
+std::vector<Json_t> JsonDocument::Value::getChild(const std::string& path) const {
+   std::vector<Json_t> retVal;
+   if (!_doc->_tape.empty())
+      _doc->getChild(_pos, tokenize(path, "/"), retVal);
+   else if (tokenize(path, "/").size() <= 1)
+      retVal.push_back(get());
+   return retVal;
+}
+
+///////////////////////////////////
+
+JsonDocument::Value JsonDocument::Iterator::operator*() const {
+   return Value(_doc, _object ? _pos + 1 : _pos);
+}
+
+std::string JsonDocument::Iterator::key() const {
+   if (!_object)
+      throw Exception("Not an object, no key");
+   return _doc->text(_pos);
+}
+
+JsonDocument::Iterator& JsonDocument::Iterator::operator++() {
+   _pos = _doc->_tape[_object ? _pos + 1 : _pos].next;
+   return *this;
+}
+
+} } // namespace elladan::json
@@ -0,0 +1,153 @@
+/*
+ * JsonDocument.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: daniel
+ */
+
+#pragma once
+
+#include <elladan/Exception.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "../json.h"
+
+namespace elladan { namespace json {
+
+class JsonHandler;
+
+/**
+ * Lazy document: the input is recorded as a flat tape (offset, extent and size of every value),
+ * the Json nodes are only built for the values asked for.
+ *
+ *    JsonDocument doc(data, size, DecodingOption());
+ *    std::vector<Json_t> names = doc.getChild("/users/*\/name");
+ *    JsonObject_t user = doc.root()["users"][3].toObject();
+ *
+ * Only the structure (brackets, delimiters, keys quotes) is checked while recording the tape. A broken
+ * string or number is reported, with its line and column, when its value is built.
+ * Duplicate keys are only rejected (DF_REJECT_DUPLICATE) when their object is built, looking a key up gives
+ * the last value as in the tree. DF_IGNORE_COMMENT and DF_ALLOW_COMMA_ERR are not supported.
+ */
+class JsonDocument
+{
+public:
+    class Iterator;
+
+    // Position of a value on the tape. Valid as long as its document.
+    class Value
+    {
+    public:
+        JsonType getType() const;
+        // Number of members or elements, 0 for anything else.
+        size_t size() const;
+
+        // Value of a member, the last one if the key is repeated. Throw if there is none.
+        Value operator[](const std::string& key) const;
+        // Element of an array, value of the idx th member of an object. Throw if out of range.
+        Value operator[](size_t idx) const;
+        // Key of the idx th member of an object.
+        std::string key(size_t idx) const;
+
+        // The elements of an array, the member values of an object, in order. Empty for anything else.
+        Iterator begin() const;
+        Iterator end() const;
+
+        // Build the Json tree of the value.
+        Json_t get() const;
+        JsonObject_t toObject() const;
+        JsonArray_t toArray() const;
+        // Build the values matching path, see Json::getChild().
+        std::vector<Json_t> getChild(const std::string& path) const;
+
+    protected:
+        friend class JsonDocument;
+        Value(const JsonDocument* doc, size_t pos) : _doc(doc), _pos(pos) {}
+
+        const JsonDocument* _doc;
+        size_t _pos;
+    };
+
+    // Forward iterator over the content of a container, each step jumps over the whole element.
+    class Iterator
+    {
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef Value value_type;
+        typedef ptrdiff_t difference_type;
+        typedef const Value* pointer;
+        typedef Value reference;
+
+        Value operator*() const;
+        // Key of the current member, for an object.
+        std::string key() const;
+
+        Iterator& operator++();
+        Iterator operator++(int) { Iterator retVal = *this; ++*this; return retVal; }
+        bool operator==(const Iterator& other) const { return _pos == other._pos; }
+        bool operator!=(const Iterator& other) const { return _pos != other._pos; }
+
+    protected:
+        friend class Value;
+        Iterator(const JsonDocument* doc, size_t pos, bool object) : _doc(doc), _pos(pos), _object(object) {}
+
+        const JsonDocument* _doc;
+        size_t _pos;        // Tape position of the element, or of the key of the member.
+        bool _object;
+    };
+
+    // Read the whole stream, the document keeps it.
+    JsonDocument(std::istream* in, DecodingOption flag);
+    // Read straight from memory, data must outlive the document.
+    JsonDocument(const char* data, size_t size, DecodingOption flag);
+
+    JsonDocument(const JsonDocument&) = delete;
+    JsonDocument& operator=(const JsonDocument&) = delete;
+
+    // The root value, of type JSON_NONE for an empty input.
+    Value root() const;
+    std::vector<Json_t> getChild(const std::string& path) const;
+
+    // Number of values recorded, keys included.
+    size_t tapeSize() const { return _tape.size(); }
+
+protected:
+    struct Entry {
+        uint32_t offset;    // First character of the value.
+        uint32_t next;      // Tape position past the value and its content.
+        uint32_t size;      // Number of members or elements of a container, length of a string or word.
+        uint32_t children;  // Where the tape positions of the elements (keys of an object) start in _children.
+    };
+
+    void build();
+    void endContainer(size_t pos, std::vector<uint32_t>& pending);
+    void throwAt(size_t offset, const std::string& err) const;
+
+    bool isObject(size_t pos) const { return _data[_tape[pos].offset] == '{'; }
+    bool isArray(size_t pos) const { return _data[_tape[pos].offset] == '['; }
+    // Tape position of the idx th element or member (its key for an object).
+    size_t child(size_t pos, size_t idx) const {
+        if (idx >= _tape[pos].size)
+            throw Exception("Index " + std::to_string(idx) + " out of range");
+        return _children[_tape[pos].children + idx];
+    }
+    std::string text(size_t pos) const;
+    bool keyIs(size_t pos, const std::string& key) const;
+    void emit(size_t pos, JsonHandler& handler) const;
+    void getChild(size_t pos, const std::vector<std::string>& parts, std::vector<Json_t>& retVal) const;
+
+    std::string _owned;
+    const char* _data;
+    size_t _size;
+    DecodingOption _flags;
+    std::vector<Entry> _tape;
+    // Tape position of every element (key of a member), grouped by container so they are found in O(1).
+    std::vector<uint32_t> _children;
+};
+
+} } // namespace elladan::json
@@ -0,0 +1,138 @@
+/*
+ * JsonHandler.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: daniel
+ */
+
+#include "JsonHandler.h"
+
+#include <elladan/Exception.h>
+#include <memory>
+
+namespace elladan { namespace json {
+
+JsonHandler::~JsonHandler() {}
+
+void JsonHandler::onNull() {}
+void JsonHandler::onBool(bool value) {}
+void JsonHandler::onInt(int64_t value) {}
+void JsonHandler::onDouble(double value) {}
+void JsonHandler::onString(const std::string& value) {}
+void JsonHandler::onBinary(const Binary_t& value) {}
+void JsonHandler::onUUID(const elladan::UUID& value) {}
+void JsonHandler::onKey(const std::string& key) {}
+void JsonHandler::onStartObject() {}
+void JsonHandler::onEndObject() {}
+void JsonHandler::onStartArray() {}
+void JsonHandler::onEndArray() {}
+
+
+JsonBuilder::JsonBuilder(DecodingOption flag) :
+   _flags(flag), _hasKey(false), _member(NEW_MEMBER) {
+}
+
+Json_t JsonBuilder::get() const {
+   return _root ? _root : std::make_shared<Json>();
+}
+
+// The events may come from a caller rather than a parser, their order is checked.
+void JsonBuilder::add(const Json_t& value) {
+   if (_stack.empty()) {
+      if (_root)
+         throw Exception("Value after the root value");
+      _root = value;
+   }
+   else if (_stack.back().isObject) {
+      if (!_hasKey)
+         throw Exception("Value without a key in an object");
+      _hasKey = false;
+      // onKey() found where the member goes, a new one is appended without searching again.
+      auto& members = static_cast<JsonObject*>(_stack.back().node)->value;
+      if (_member == NEW_MEMBER)
+         members.emplace_back(_key, value);
+      else
+         (members.begin() + _member)->second = value;
+   }
+   else
+      static_cast<JsonArray*>(_stack.back().node)->value.push_back(value);
+}
+
+void JsonBuilder::onNull() {
+   add(std::make_shared<JsonNull>());
+}
+void JsonBuilder::onBool(bool value) {
+   add(std::make_shared<JsonBool>(value));
+}
+void JsonBuilder::onInt(int64_t value) {
+   add(std::make_shared<JsonInt>(value));
+}
+void JsonBuilder::onDouble(double value) {
+   add(std::make_shared<JsonDouble>(value));
+}
+void JsonBuilder::onString(const std::string& value) {
+   add(std::make_shared<JsonString>(value));
+}
+void JsonBuilder::onBinary(const Binary_t& value) {
+   add(std::make_shared<JsonBinary>(value));
+}
+void JsonBuilder::onUUID(const elladan::UUID& value) {
+   add(std::make_shared<JsonUUID>(value));
+}
+
+/**
+ * Small objects are searched, the larger ones get a hash table of their keys
+ * so that adding every key of a large object is not quadratic.
+ */
+size_t JsonBuilder::findMember(Level& level, const std::string& key) {
+   auto& members = static_cast<JsonObject*>(level.node)->value;
+   if (!level.keys) {
+      if (members.size() < HASHED_KEYS) {
+         auto ite = members.find(key);
+         return ite == members.end() ? NEW_MEMBER : ite - members.begin();
+      }
+
+      level.keys.reset(new std::unordered_map<std::string, size_t>());
+      level.keys->reserve(2 * HASHED_KEYS);
+      for (size_t i = 0; i < members.size(); i++)
+         level.keys->emplace((members.begin() + i)->first, i);
+   }
+   // A new key is appended by add(), at the end of the members.
+   auto ins = level.keys->emplace(key, members.size());
+   return ins.second ? NEW_MEMBER : ins.first->second;
+}
+
+void JsonBuilder::onKey(const std::string& key) {
+   if (_stack.empty() || !_stack.back().isObject || _hasKey)
+      throw Exception("Key " + key + " outside of an object");
+   _member = findMember(_stack.back(), key);
+   if (_member != NEW_MEMBER && _flags.test(DecodingFlags::DF_REJECT_DUPLICATE))
+      throw Exception("Duplicate value " + key);
+
+   _key = key;
+   _hasKey = true;
+}
+
+void JsonBuilder::onStartObject() {
+   JsonObject_t obj = std::make_shared<JsonObject>();
+   add(obj);
+   _stack.push_back({obj.get(), true, nullptr});
+}
+void JsonBuilder::onEndObject() {
+   if (_stack.empty() || !_stack.back().isObject || _hasKey)
+      throw Exception("Unexpected }");
+   _stack.pop_back();
+}
+
+void JsonBuilder::onStartArray() {
+   JsonArray_t arr = std::make_shared<JsonArray>();
+   add(arr);
+   _stack.push_back({arr.get(), false, nullptr});
+}
+void JsonBuilder::onEndArray() {
+   if (_stack.empty() || _stack.back().isObject)
+      throw Exception("Unexpected ]");
+   _stack.pop_back();
+}
+
+} } // namespace elladan::json
@@ -0,0 +1,118 @@
+/*
+ * JsonHandler.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: daniel
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include "../json.h"
+
+namespace elladan { namespace json {
+
+/**
+ * Receive the content of a document as it is decoded, without building any tree.
+ * Every event does nothing by default, override the ones you care about.
+ * Object members are reported as onKey() followed by the value events.
+ */
+class JsonHandler
+{
+public:
+    virtual ~JsonHandler();
+
+    virtual void onNull();
+    virtual void onBool(bool value);
+    virtual void onInt(int64_t value);
+    virtual void onDouble(double value);
+    virtual void onString(const std::string& value);
+    virtual void onBinary(const Binary_t& value);   // Only in bson.
+    virtual void onUUID(const elladan::UUID& value); // Only in bson.
+
+    virtual void onKey(const std::string& key);
+    virtual void onStartObject();
+    virtual void onEndObject();
+    virtual void onStartArray();
+    virtual void onEndArray();
+
+    /**
+     * Drive the handler by hand, one value at a time : JsonWriter and BsonWriter emit the document straight to
+     * their output, JsonBuilder builds the tree.
+     *   writer.beginObject().key("id").value(42).key("tags").beginArray().value("a").endArray().endObject();
+     */
+    JsonHandler& beginObject()                      { onStartObject(); return *this; }
+    JsonHandler& endObject()                        { onEndObject(); return *this; }
+    JsonHandler& beginArray()                       { onStartArray(); return *this; }
+    JsonHandler& endArray()                         { onEndArray(); return *this; }
+    JsonHandler& key(const std::string& key)        { onKey(key); return *this; }
+
+    JsonHandler& value(std::nullptr_t)              { onNull(); return *this; }
+    JsonHandler& value(bool value)                  { onBool(value); return *this; }
+    template <typename T, typename std::enable_if<std::is_integral<T>::value && !std::is_same<T, bool>::value, int>::type = 0>
+    JsonHandler& value(T value)                     { onInt((int64_t) value); return *this; }
+    JsonHandler& value(double value)                { onDouble(value); return *this; }
+    JsonHandler& value(const char* value)           { onString(value); return *this; }
+    JsonHandler& value(const std::string& value)    { onString(value); return *this; }
+    JsonHandler& value(const Binary_t& value)       { onBinary(value); return *this; }
+    JsonHandler& value(const elladan::UUID& value)  { onUUID(value); return *this; }
+};
+
+/**
+ * Build the Json tree out of the events. The events give one root value, a second one throws.
+ */
+class JsonBuilder : public JsonHandler
+{
+public:
+    JsonBuilder(DecodingOption flag = DecodingOption());
+
+    // The decoded root, a JsonNone if nothing was decoded.
+    Json_t get() const;
+
+    void onNull();
+    void onBool(bool value);
+    void onInt(int64_t value);
+    void onDouble(double value);
+    void onString(const std::string& value);
+    void onBinary(const Binary_t& value);
+    void onUUID(const elladan::UUID& value);
+
+    void onKey(const std::string& key);
+    void onStartObject();
+    void onEndObject();
+    void onStartArray();
+    void onEndArray();
+
+protected:
+    void add(const Json_t& value);
+
+    // The keys of an object are hashed once it has that many members.
+    static const size_t HASHED_KEYS = 32;
+    // Member index of a key the object does not have yet.
+    static const size_t NEW_MEMBER = (size_t) -1;
+
+    struct Level {
+        Json* node;
+        bool isObject;
+        std::unique_ptr<std::unordered_map<std::string, size_t>> keys;   // Member index of each key, once hashed.
+    };
+
+    // Index of the member named key, NEW_MEMBER if there is none.
+    size_t findMember(Level& level, const std::string& key);
+
+    DecodingOption _flags;
+    std::vector<Level> _stack;
+    std::string _key;
+    bool _hasKey;                   // A key waits for its value.
+    size_t _member;                 // Where the value of the key goes.
+    Json_t _root;
+};
+
+} } // namespace elladan::json
@@ -0,0 +1,78 @@
+/*
+ * JsonLines.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: daniel
+ */
+
+#include "JsonLines.h"
+
+#include <elladan/Exception.h>
+#include <cstring>
+
+#include "JsonSerializer.h"
+#include "JsonStream.h"
+
+namespace elladan { namespace json {
+
+Json_t JsonLines::parseRecord(const char* data, size_t size, size_t line, DecodingOption flag) {
+   SIStream in(data, size, flag);
+   // Report errors at their position in the whole input.
+   in.setFirstLine(line);
+
+   char cur;
+   if (!(in() >> cur))
+      return Json_t();
+
+   Json_t retVal = JsonSerializer::readJson(in, cur);
+   if (in() >> cur)
+      in.throwErr("Unexpected data after the record");
+   return retVal;
+}
+
+size_t JsonLines::frame(const char* data, size_t size, size_t limit, bool end, size_t, std::vector<const char*>& starts) {
+   starts.clear();
+   const char* last = data + size;
+   const char* p = data;
+   while (p < last && (size_t) (p - data) < limit) {
+      const char* nl = (const char*) memchr(p, '\n', last - p);
+      // The last line is complete only at the end of the input.
+      if (!nl && !end)
+         break;
+      starts.push_back(p);
+      p = nl ? nl + 1 : last;
+   }
+   starts.push_back(p);
+   return p - data;
+}
+
+RecordBatches::Decode JsonLines::decoder(DecodingOption flag) {
+   // The records are the lines, so the record index is the line number.
+   return [flag](const char* record, size_t len, size_t line, size_t) {
+      return parseRecord(record, len, line, flag);
+   };
+}
+
+void JsonLines::parse(const char* data, size_t size, const Callback& callback, DecodingOption flag, unsigned threads) {
+   RecordBatches batches(frame, decoder(flag), BATCH_SIZE, threads);
+   batches.parse(data, size, callback);
+}
+
+std::vector<Json_t> JsonLines::parse(const char* data, size_t size, DecodingOption flag, unsigned threads) {
+   std::vector<Json_t> retVal;
+   parse(data, size, [&](const Json_t& record) { retVal.push_back(record); }, flag, threads);
+   return retVal;
+}
+
+void JsonLines::read(std::istream* in, const Callback& callback, DecodingOption flag, unsigned threads) {
+   RecordBatches batches(frame, decoder(flag), BATCH_SIZE, threads);
+   batches.read(in, callback);
+}
+
+std::vector<Json_t> JsonLines::read(std::istream* in, DecodingOption flag, unsigned threads) {
+   std::vector<Json_t> retVal;
+   read(in, [&](const Json_t& record) { retVal.push_back(record); }, flag, threads);
+   return retVal;
+}
+
+} } // namespace elladan::json
@@ -0,0 +1,48 @@
+/*
+ * JsonLines.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: daniel
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "../json.h"
+#include "../parallel.h"
+
+namespace elladan { namespace json {
+
+/**
+ * Newline delimited json (NDJSON) : one value per line, blank lines are ignored.
+ * The input is cut in batches of lines, each batch is parsed over a pool of threads.
+ * Records are always given back in input order.
+ */
+class JsonLines
+{
+public:
+    typedef std::function<void(const Json_t& record)> Callback;
+
+    // threads : number of threads to use, 0 for one per core.
+    static std::vector<Json_t> read(std::istream* in, DecodingOption flag, unsigned threads);
+    static void read(std::istream* in, const Callback& callback, DecodingOption flag, unsigned threads);
+    static std::vector<Json_t> parse(const char* data, size_t size, DecodingOption flag, unsigned threads);
+    static void parse(const char* data, size_t size, const Callback& callback, DecodingOption flag, unsigned threads);
+
+protected:
+    // Bytes read from the stream per thread before a batch is parsed.
+    static constexpr size_t BATCH_SIZE = 4 * 1024 * 1024;
+
+    // Cut the lines, see RecordBatches::Frame.
+    static size_t frame(const char* data, size_t size, size_t limit, bool end, size_t offset, std::vector<const char*>& starts);
+    static RecordBatches::Decode decoder(DecodingOption flag);
+    // Decode one line, a null Json_t for a blank line.
+    static Json_t parseRecord(const char* data, size_t size, size_t line, DecodingOption flag);
+};
+
+} } // namespace elladan::json
@@ -0,0 +1,376 @@
+/*
+ * JsonPushParser.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: daniel
+ */
+
+#include "JsonPushParser.h"
+
+#include <elladan/Exception.h>
+#include <elladan/FlagSet.h>
+#include <cctype>
+
+#include "../utf.h"
+#include "JsonSerializer.h"
+#include "JsonStream.h"
+#include "StringScan.h"
+
+namespace elladan { namespace json {
+
+JsonPushParser::JsonPushParser(JsonHandler& handler, DecodingOption flag) :
+   _handler(&handler), _builder(flag), _flags(flag) {
+   reset();
+}
+
+JsonPushParser::JsonPushParser(DecodingOption flag) :
+   _handler(&_builder), _builder(flag), _flags(flag) {
+   reset();
+}
+
+void JsonPushParser::reset() {
+   _builder = JsonBuilder(_flags);
+   _values.clear();
+   _ready = 0;
+   _state = ST_VALUE;
+   _resume = ST_VALUE;
+   _stack.clear();
+   _text.clear();
+   _isKey = false;
+   _hexCount = 0;
+   _code = 0;
+   _high = 0;
+   _line = 0;
+   _col = -1;
+}
+
+bool JsonPushParser::inValue() const {
+   return !_stack.empty() || _state != ST_VALUE;
+}
+
+Json_t JsonPushParser::popValue() {
+   Json_t retVal = _values.front();
+   _values.pop_front();
+   return retVal;
+}
+
+size_t JsonPushParser::feed(const char* data, size_t size) {
+   _ready = 0;
+   const char* end = data + size;
+
+   for (const char* p = data; p < end; p++) {
+      // Append the run of plain characters in one go.
+      if (_state == ST_STRING) {
+         const char* special = StringScan::findSpecial(p, end);
+         _text.append(p, special);
+         _col += special - p;
+         p = special;
+         if (p == end)
+            break;
+      }
+
+      char c = *p;
+      _col++;
+      if (c == '\n') {
+         _line++;
+         _col = 0;
+      }
+
+      while (!step(c));
+   }
+   return _ready;
+}
+
+size_t JsonPushParser::finish() {
+   _ready = 0;
+   if (_state == ST_WORD)
+      endWord();
+   if (_state == ST_LINE_COMMENT)
+      _state = _resume;
+   if (inValue())
+      throwErr("Unexpected EOF");
+   return _ready;
+}
+
+bool JsonPushParser::step(char c) {
+   switch (_state) {
+      case ST_VALUE:
+         if (!isBlank(c))
+            startValue(c);
+         return true;
+
+      case ST_OBJECT_FIRST:
+         if (isBlank(c))
+            return true;
+         if (c == '}') {
+            close(c);
+            return true;
+         }
+         if (c != '"')
+            throwErr("Missing key");
+         _isKey = true;
+         _text.clear();
+         _state = ST_STRING;
+         return true;
+
+      case ST_ARRAY_FIRST:
+         if (isBlank(c))
+            return true;
+         if (c == ']')
+            close(c);
+         else
+            startValue(c);
+         return true;
+
+      case ST_COLON:
+         if (isBlank(c))
+            return true;
+         _state = ST_VALUE;
+         if (c == ':')
+            return true;
+         if (!_flags.test(DecodingFlags::DF_ALLOW_COMMA_ERR))
+            throwErr("Expecting array key value delimiter \":\"");
+         return false;
+
+      case ST_NEXT: {
+         if (isBlank(c))
+            return true;
+         bool isObject = _stack.back() == '{';
+         if (c == (isObject ? '}' : ']')) {
+            close(c);
+            return true;
+         }
+         _state = isObject ? ST_OBJECT_FIRST : ST_ARRAY_FIRST;
+         if (c == ',')
+            return true;
+         if (!_flags.test(DecodingFlags::DF_ALLOW_COMMA_ERR))
+            throwErr("Expected an element delimiter \',\'");
+         return false;
+      }
+
+      case ST_STRING:
+         switch (c) {
+            case '"':
+               endString();
+               break;
+            case '\\':
+               _state = ST_ESCAPE;
+               break;
+            case '\0':
+               if (!_flags.test(DecodingFlags::DF_ALLOW_NULL))
+                  throwErr("Found null value in string");
+               /* no break */
+            default:
+               _text.push_back(c);
+               break;
+         }
+         return true;
+
+      case ST_ESCAPE:
+         _state = ST_STRING;
+         switch (c) {
+            case '"':    _text.push_back('"');   break;
+            case '/':    _text.push_back('/');   break;
+            case '\\':   _text.push_back('\\');  break;
+            case 'b':    _text.push_back('\b');  break;
+            case 'f':    _text.push_back('\f');  break;
+            case 'n':    _text.push_back('\n');  break;
+            case 'r':    _text.push_back('\r');  break;
+            case 't':    _text.push_back('\t');  break;
+            case '0':
+               if (!_flags.test(DecodingFlags::DF_ALLOW_NULL))
+                  throwErr("Found null value in string");
+               _text.push_back('\0');
+               break;
+            case 'u':
+               _state = ST_UNICODE;
+               _hexCount = 0;
+               _code = 0;
+               break;
+            default:
+               throwErr("Invalid escape");
+               break;
+         }
+         return true;
+
+      case ST_UNICODE: {
+         int digit = hexValue(c);
+         if (digit < 0)
+            throwErr("Invalid unicode escape");
+         _code = (_code << 4) | digit;
+         if (++_hexCount < 4)
+            return true;
+
+         // Second half of a surrogate pair.
+         if (_high) {
+            if (_code < 0xDC00 || _code >= 0xE000)
+               throwErr("Invalid unicode escape");
+            _code = ((_high - 0xD800) << 10) + (_code - 0xDC00) + 0x10000;
+            _high = 0;
+         }
+         else if (_code >= 0xDC00 && _code < 0xE000)
+            throwErr("Invalid unicode escape");
+         else if (_code >= 0xD800 && _code < 0xDC00) {
+            _high = _code;
+            _state = ST_LOW_BACKSLASH;
+            return true;
+         }
+
+         char unicode[4];
+         size_t length;
+         if (Utf8::encode(_code, unicode, &length))
+            throwErr("Could not process unicode");
+         _text.append(unicode, length);
+         _state = ST_STRING;
+         return true;
+      }
+
+      case ST_LOW_BACKSLASH:
+         if (c != '\\')
+            throwErr("Invalid unicode escape");
+         _state = ST_LOW_U;
+         return true;
+
+      case ST_LOW_U:
+         if (c != 'u')
+            throwErr("Invalid unicode escape");
+         _state = ST_UNICODE;
+         _hexCount = 0;
+         _code = 0;
+         return true;
+
+      case ST_WORD:
+         if (isWordChar(c)) {
+            _text.push_back(c);
+            return true;
+         }
+         endWord();
+         return false;
+
+      case ST_COMMENT_START:
+         if (c == '*')
+            _state = ST_BLOCK_COMMENT;
+         else if (c == '/')
+            _state = ST_LINE_COMMENT;
+         else
+            throwErr("Invalid comment");
+         return true;
+
+      case ST_LINE_COMMENT:
+         if (c == '\n')
+            _state = _resume;
+         return true;
+
+      case ST_BLOCK_COMMENT:
+         if (c == '*')
+            _state = ST_BLOCK_COMMENT_STAR;
+         return true;
+
+      case ST_BLOCK_COMMENT_STAR:
+         if (c == '/')
+            _state = _resume;
+         else if (c != '*')
+            _state = ST_BLOCK_COMMENT;
+         return true;
+   }
+   return true;
+}
+
+bool JsonPushParser::isBlank(char c) {
+   if (std::isspace(c))
+      return true;
+   if (c == '/' && _flags.test(DecodingFlags::DF_IGNORE_COMMENT)) {
+      _resume = _state;
+      _state = ST_COMMENT_START;
+      return true;
+   }
+   return false;
+}
+
+void JsonPushParser::startValue(char c) {
+   if ((c == '{' || c == '[') && _stack.size() >= _flags.getMaxDepth())
+      throwErr("Maximum depth exceeded");
+
+   switch (c) {
+      case '{':
+         _handler->onStartObject();
+         _stack.push_back(c);
+         _state = ST_OBJECT_FIRST;
+         break;
+
+      case '[':
+         _handler->onStartArray();
+         _stack.push_back(c);
+         _state = ST_ARRAY_FIRST;
+         break;
+
+      case '"':
+         _isKey = false;
+         _text.clear();
+         _state = ST_STRING;
+         break;
+
+      default:
+         if (!isWordChar(c))
+            throwErr("Expected value, nothing found");
+         _text.assign(1, c);
+         _state = ST_WORD;
+         break;
+   }
+}
+
+void JsonPushParser::endString() {
+   if (!_isKey) {
+      _handler->onString(_text);
+      endValue();
+      return;
+   }
+
+   // The handler may reject the key (duplicate, ...), report it where it was found.
+   try {
+      _handler->onKey(_text);
+   }
+   catch (Exception& e) {
+      throwErr(e.what());
+   }
+   _state = ST_COLON;
+}
+
+void JsonPushParser::endWord() {
+   if (!JsonSerializer::readWord(_text.data(), _text.size(), _flags, *_handler))
+      throwErr("Could not identity type of " + _text);
+   endValue();
+}
+
+void JsonPushParser::close(char c) {
+   _stack.pop_back();
+   if (c == '}')
+      _handler->onEndObject();
+   else
+      _handler->onEndArray();
+   endValue();
+}
+
+void JsonPushParser::endValue() {
+   if (!_stack.empty()) {
+      _state = ST_NEXT;
+      return;
+   }
+
+   // A whole value is ready.
+   _ready++;
+   _state = ST_VALUE;
+   if (_handler == &_builder) {
+      _values.push_back(_builder.get());
+      _builder = JsonBuilder(_flags);
+   }
+}
+
+void JsonPushParser::throwErr(const std::string& err) const {
+   Pos pos;
+   pos.line = _line;
+   pos.col = _col;
+   pos.throwErr(err);
+}
+
+} } // namespace elladan::json
@@ -0,0 +1,107 @@
+/*
+ * JsonPushParser.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: daniel
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <deque>
+#include <string>
+#include <vector>
+
+#include "../json.h"
+#include "JsonHandler.h"
+
+namespace elladan { namespace json {
+
+/**
+ * Incremental parser: the input is given as it arrives, in chunks of any size.
+ * A value may be cut anywhere (inside a string, an escape, a number, ...), the state is kept until the next chunk.
+ * Several values can follow each other in the input. A number at the root is only complete once
+ * the character following it (or the end of the input) is known.
+ *
+ *    JsonPushParser parser(DecodingOption());
+ *    while ((len = recv(sock, buf, sizeof(buf), 0)) > 0) {
+ *       parser.feed(buf, len);
+ *       while (parser.hasValue())
+ *          process(parser.popValue());
+ *    }
+ *    parser.finish();
+ *
+ * Errors are thrown with their line and column. The parser can't be used after an error until reset() is called.
+ */
+class JsonPushParser
+{
+public:
+    // Report the values to the handler.
+    JsonPushParser(JsonHandler& handler, DecodingOption flag);
+    // Build the values, get them with popValue().
+    JsonPushParser(DecodingOption flag);
+
+    // Parse the chunk. Return the number of values completed by it.
+    size_t feed(const char* data, size_t size);
+    // End of the input: a number at the very end is completed, throw if a value is incomplete. Return the number of values completed.
+    size_t finish();
+    // Forget the current state, to start again on a new input.
+    void reset();
+
+    // True if a value is inside an object/array, a string, a number...
+    bool inValue() const;
+
+    // Values built when no handler was given, in input order.
+    bool hasValue() const { return !_values.empty(); }
+    Json_t popValue();
+
+protected:
+    enum State {
+       ST_VALUE,            // Expect a value.
+       ST_OBJECT_FIRST,     // After '{' or ',' in an object : expect a key or '}'.
+       ST_ARRAY_FIRST,      // After '[' or ',' in an array : expect a value or ']'.
+       ST_COLON,            // After a key.
+       ST_NEXT,             // After a value in an object/array : expect ',' or the end of it.
+       ST_STRING,
+       ST_ESCAPE,           // After '\' in a string.
+       ST_UNICODE,          // Reading the 4 hex digits of \u.
+       ST_LOW_BACKSLASH,    // After a high surrogate, expect "\u".
+       ST_LOW_U,
+       ST_WORD,             // Number, true, false, null...
+       ST_COMMENT_START,    // After '/'.
+       ST_LINE_COMMENT,
+       ST_BLOCK_COMMENT,
+       ST_BLOCK_COMMENT_STAR,
+    };
+
+    // Handle one character, return false if it must be handled again in the new state.
+    bool step(char c);
+    // White space or the start of a comment.
+    bool isBlank(char c);
+    void startValue(char c);
+    void endString();
+    void endWord();
+    void endValue();
+    void close(char c);
+    void throwErr(const std::string& err) const;
+
+    JsonHandler* _handler;
+    JsonBuilder _builder;
+    DecodingOption _flags;
+    std::deque<Json_t> _values;
+    size_t _ready;
+
+    State _state;
+    State _resume;               // State to go back to after a comment.
+    std::vector<char> _stack;    // '{' or '[' for each open container.
+    std::string _text;           // String or word being read.
+    bool _isKey;
+    int _hexCount;
+    int _code;
+    int _high;                   // High surrogate waiting for its low part.
+
+    size_t _line;
+    size_t _col;
+};
+
+} } // namespace elladan::json
@@ -0,0 +1,211 @@
+/*
+ * JsonReader.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: daniel
+ */
+
+#include "JsonReader.h"
+
+#include <elladan/FlagSet.h>
+
+#include "JsonHandler.h"
+#include "JsonSerializer.h"
+#include "JsonStream.h"
+
+namespace elladan { namespace json {
+
+// Keep the scalar decoded by JsonSerializer::parseJson().
+class JsonReader::Capture : public JsonHandler
+{
+public:
+   Capture(JsonReader& reader) : _reader(reader) {}
+
+   void onNull() {
+      _reader._token = TK_NULL;
+   }
+   void onBool(bool value) {
+      _reader._token = TK_BOOL;
+      _reader._bool = value;
+   }
+   void onInt(int64_t value) {
+      _reader._token = TK_INT;
+      _reader._int = value;
+   }
+   void onDouble(double value) {
+      _reader._token = TK_DOUBLE;
+      _reader._double = value;
+   }
+   void onString(const std::string& value) {
+      _reader._token = TK_STRING;
+      _reader._string = value;
+   }
+
+protected:
+   JsonReader& _reader;
+};
+
+JsonReader::JsonReader(std::istream* in, DecodingOption flag) :
+   _in(new SIStream(in, flag)), _state(ST_ROOT), _token(TK_END), _int(0), _double(0), _bool(false) {
+}
+
+JsonReader::JsonReader(const char* data, size_t size, DecodingOption flag) :
+   _in(new SIStream(data, size, flag)), _state(ST_ROOT), _token(TK_END), _int(0), _double(0), _bool(false) {
+}
+
+JsonReader::~JsonReader() {
+}
+
+bool JsonReader::advance(char& cur) {
+   SIStream& in = *_in;
+
+   switch (_state) {
+      case ST_DONE:
+         _token = TK_END;
+         return false;
+
+      case ST_ROOT:
+         if (!(in() >> cur)) {
+            _state = ST_DONE;
+            _token = TK_END;
+            return false;
+         }
+         return true;
+
+      case ST_VALUE:
+         in("looking for object value") >> cur;
+         return true;
+
+      case ST_FIRST:
+         in("looking for the end of the container") >> cur;
+         break;
+
+      case ST_NEXT:
+         if (in.nesting.empty()) {
+            _state = ST_DONE;
+            _token = TK_END;
+            return false;
+         }
+
+         in("looking for element delimiter \',\' or closing bracket") >> cur;
+         if (cur == ',')
+            in("looking for next element") >> cur;
+         else if (cur != (in.nesting.back() == '{' ? '}' : ']') && !in.flags.test(DecodingFlags::DF_ALLOW_COMMA_ERR))
+            in.throwErr("Expected an element delimiter \',\'");
+         break;
+   }
+
+   // Inside a container: its end, a key or a value.
+   bool isObject = in.nesting.back() == '{';
+   if (cur == (isObject ? '}' : ']')) {
+      in.nesting.pop_back();
+      _state = ST_NEXT;
+      _token = isObject ? TK_END_OBJECT : TK_END_ARRAY;
+      return false;
+   }
+
+   if (!isObject)
+      return true;
+
+   if (cur != '"')
+      in.throwErr("Missing key");
+   JsonSerializer::jsonToString(in, _string);
+
+   in("looking for key value delimiter \':\'") >> cur;
+   if (cur != ':') {
+      if (!in.flags.test(DecodingFlags::DF_ALLOW_COMMA_ERR))
+         in.throwErr("Expecting array key value delimiter \":\"");
+      in.pushBack(cur);
+   }
+
+   _state = ST_VALUE;
+   _token = TK_KEY;
+   return false;
+}
+
+JsonReader::Token JsonReader::next() {
+   char cur;
+   if (!advance(cur))
+      return _token;
+
+   switch (cur) {
+      case '{':
+      case '[':
+         _in->open(cur);
+         _state = ST_FIRST;
+         _token = cur == '{' ? TK_START_OBJECT : TK_START_ARRAY;
+         break;
+
+      default: {
+         Capture capture(*this);
+         JsonSerializer::parseJson(*_in, cur, capture);
+         _state = ST_NEXT;
+      } break;
+   }
+   return _token;
+}
+
+void JsonReader::skipValue() {
+   char cur;
+   if (!advance(cur)) {
+      if (_token != TK_KEY)
+         expected("a value");
+      advance(cur);
+   }
+
+   JsonSerializer::skipJson(*_in, cur);
+   _state = ST_NEXT;
+}
+
+Json_t JsonReader::readValue() {
+   char cur;
+   if (!advance(cur))
+      expected("a value");
+
+   Json_t retVal = JsonSerializer::readJson(*_in, cur);
+   _state = ST_NEXT;
+   return retVal;
+}
+
+std::string JsonReader::readKey() {
+   if (next() != TK_KEY)
+      expected("a key");
+   return _string;
+}
+
+std::string JsonReader::readString() {
+   if (next() != TK_STRING)
+      expected("a string");
+   return _string;
+}
+
+int64_t JsonReader::readInt64() {
+   if (next() != TK_INT)
+      expected("an integer");
+   return _int;
+}
+
+double JsonReader::readDouble() {
+   next();
+   if (_token == TK_INT)
+      return _int;
+   if (_token != TK_DOUBLE)
+      expected("a number");
+   return _double;
+}
+
+bool JsonReader::readBool() {
+   if (next() != TK_BOOL)
+      expected("a boolean");
+   return _bool;
+}
+
+size_t JsonReader::depth() const {
+   return _in->nesting.size();
+}
+
+void JsonReader::expected(const char* what) {
+   _in->throwErr(std::string("Expected ") + what);
+}
+
+} } // namespace elladan::json
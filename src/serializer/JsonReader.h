@@ -0,0 +1,111 @@
+/*
+ * JsonReader.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: daniel
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include "../json.h"
+
+namespace elladan { namespace json {
+
+class SIStream;
+
+/**
+ * Pull parser: walk a json text one token at a time.
+ * Nothing is allocated for the values that are skipped, only the pieces asked for are decoded.
+ * Errors are reported with their line and column, as with Json::read.
+ *
+ *    JsonReader reader(&in, DecodingOption());
+ *    reader.next();                                     // TK_START_OBJECT
+ *    while (reader.next() == JsonReader::TK_KEY) {
+ *       if (reader.getString() == "id")
+ *          id = reader.readInt64();
+ *       else
+ *          reader.skipValue();
+ *    }
+ */
+class JsonReader
+{
+public:
+    enum Token {
+       TK_END,           // End of the root value or of the input.
+       TK_START_OBJECT,
+       TK_END_OBJECT,
+       TK_START_ARRAY,
+       TK_END_ARRAY,
+       TK_KEY,           // Object key, the value is the next token.
+       TK_STRING,
+       TK_INT,
+       TK_DOUBLE,
+       TK_BOOL,
+       TK_NULL,
+    };
+
+    // The stream is left right after the root value once the reader is destroyed.
+    JsonReader(std::istream* in, DecodingOption flag);
+    // Read straight from memory, data must outlive the reader.
+    JsonReader(const char* data, size_t size, DecodingOption flag);
+    ~JsonReader();
+
+    // Move to the next token.
+    Token next();
+    // Last token returned by next().
+    Token token() const { return _token; }
+
+    // Value of the last token.
+    const std::string& getString() const { return _string; }   // TK_KEY and TK_STRING
+    int64_t getInt() const { return _int; }                     // TK_INT
+    double getDouble() const { return _double; }                // TK_DOUBLE
+    bool getBool() const { return _bool; }                      // TK_BOOL
+
+    // Skip the next value, whole objects and arrays included. A pending key is skipped along with its value.
+    void skipValue();
+    // Decode the next value as a tree.
+    Json_t readValue();
+    // Read the next token, throw if it is not of the expected type.
+    std::string readKey();
+    std::string readString();
+    int64_t readInt64();
+    double readDouble();
+    bool readBool();
+
+    // Number of objects and arrays currently open.
+    size_t depth() const;
+
+protected:
+    class Capture;
+
+    enum State {
+       ST_ROOT,          // Nothing read yet.
+       ST_VALUE,         // A value is expected (after a key).
+       ST_FIRST,         // Right after '{' or '['.
+       ST_NEXT,          // After a value, expect a delimiter or the end of the container.
+       ST_DONE,          // The root value has been read.
+    };
+
+    // Handle the delimiters. Return true with the first char of the value if a value follows,
+    // otherwise the key or closing token is set in _token.
+    bool advance(char& cur);
+    // Report the token not found where it was expected.
+    void expected(const char* what);
+
+    std::unique_ptr<SIStream> _in;   // Its nesting holds '{' or '[' for each open container.
+    State _state;
+    Token _token;
+
+    std::string _string;
+    int64_t _int;
+    double _double;
+    bool _bool;
+};
+
+} } // namespace elladan::json
@@ -17,12 +17,21 @@
 #include <cctype>
 #include <cstdint>
 #include <cstdio>
+#include <cstring>
 #include <memory>
 #include <sstream>
 #include <utility>
 #include <vector>
 
+#include "../parallel.h"
 #include "../utf.h"
+#include "JsonHandler.h"
+#include "JsonStream.h"
+#include "JsonWriter.h"
+#include "Number.h"
+#include "OutputSink.h"
+#include "StringScan.h"
+#include "StructuralIndex.h"
 
 using std::to_string;
 
@@ -31,98 +40,85 @@ namespace json {
 
 class SOStream {
 public:
-   std::ostream* _out;
+   OutputBuffer& _out;
 
-   SOStream(std::ostream* out) :
+   SOStream(OutputBuffer& out) :
       _out(out) {
    }
 
-   SOStream& operator <<(std::string& str);
    SOStream& operator <<(const std::string& str);
-   SOStream& write(void* data, size_t size);
+   SOStream& operator <<(const char* str);
+   SOStream& write(const void* data, size_t size);
+   SOStream& put(char c) {
+      _out.put(c);
+      return *this;
+   }
 };
 
-SOStream& SOStream::operator <<(std::string& str) {
-   _out->write(str.c_str(), str.size());
+SOStream& SOStream::operator <<(const std::string& str) {
+   _out.write(str.c_str(), str.size());
    return *this;
 }
-SOStream& SOStream::operator <<(const std::string& str) {
-   _out->write(str.c_str(), str.size());
+SOStream& SOStream::operator <<(const char* str) {
+   _out.write(str, strlen(str));
    return *this;
 }
-SOStream& SOStream::write(void* data, size_t size) {
-   _out->write((char*) data, size);
+SOStream& SOStream::write(const void* data, size_t size) {
+   _out.write((const char*) data, size);
    return *this;
 }
 
-std::string JsonSerializer::stringToJson(const std::string& txt, EncodingOption flag) {
-   std::ostringstream out;
-
-   const char *ite, *lim;
-   int32_t codepoint;
-
-   out << "\"";
+// Copy the runs that need no escape as they are, only look at the characters ending them.
+void JsonSerializer::writeString(SOStream& out, const std::string& txt, EncodingOption flag) {
+   static const char hexDigits[] = "0123456789ABCDEF";
+   bool slash = flag.test(EncodingFlags::EF_JSON_ESCAPE_SLASH);
+   const char* ite = txt.data();
+   const char* lim = ite + txt.size();
 
-   ite = txt.c_str();
-   lim = ite + txt.length();
-
-   // Look for first special character.
+   out.put('"');
    while (ite < lim) {
-      ite = Utf8::iterate(ite, lim - ite, &codepoint);
-      if (!ite)
-         //        	throw Exception(std::string("Invalid utf8 code at position ") + ite-txt.c_str() + " in " + txt);
+      const char* run = StringScan::findEscape(ite, lim, slash);
+      out.write(ite, run - ite);
+      ite = run;
+      if (ite == lim)
          break;
 
-      // Handle \, /, ", and control codes
-      if (
-            // mandatory escape or control char
-            codepoint == '\\' || codepoint == '"' || codepoint < 0x20 ||
-            // escape slash
-            (flag.test(EncodingFlags::EF_JSON_ESCAPE_SLASH) && codepoint == '/'))
-      {
-         switch (codepoint) {
-            case '\\':  out << "\\\\";   break;
-            case '\"':  out << "\\\"";   break;
-            case '\b':  out << "\\b";    break;
-            case '\f':  out << "\\f";    break;
-            case '\n':  out << "\\n";    break;
-            case '\r':  out << "\\r";    break;
-            case '\t':  out << "\\t";    break;
-            case '/':   out << "\\/";    break;
-            default: {
-               // codepoint is in BMP
-               if (codepoint < 0x10000) {
-                  char seq[7];
-                  snprintf(seq, sizeof(seq), "\\u%04X", (unsigned int) codepoint);
-                  out << seq;
-               }
-
-               // not in BMP -> construct a UTF-16 surrogate pair
-               else {
-                  char seq[13];
-
-                  int32_t first, last;
-
-                  codepoint -= 0x10000;
-                  first = 0xD800 | ((codepoint & 0xffc00) >> 10);
-                  last = 0xDC00 | (codepoint & 0x003ff);
-
-                  snprintf(seq, sizeof(seq), "\\u%04X\\u%04X", (unsigned int) first, (unsigned int) last);
-                  out << seq;
-               }
-            }
-            break;
+      // Non ascii : keep the utf8 sequences as they are, stop at an invalid one.
+      if ((unsigned char) *ite >= 0x80) {
+         const char* begin = ite;
+         int32_t codepoint;
+         while (ite < lim && (unsigned char) *ite >= 0x80) {
+            const char* next = Utf8::iterate(ite, lim - ite, &codepoint);
+            if (!next)
+               break;
+            if (flag.test(EncodingFlags::EF_JSON_ENSURE_ASCII))
+               throw Exception("Could not encode non UTF code " + to_string(codepoint));
+            ite = next;
          }
+         out.write(begin, ite - begin);
+         if (ite < lim && (unsigned char) *ite >= 0x80)
+            break;
+         continue;
       }
-      // non-ASCII
-      else if (flag.test(EncodingFlags::EF_JSON_ENSURE_ASCII) && codepoint > 0x7F)
-         throw Exception("Could not encode non UTF code " + to_string(codepoint));
-      else
-         out.put(codepoint);
-   }
 
-   out << "\"";
-   return out.str();
+      // Handle \, /, ", and control codes
+      switch (*ite) {
+         case '\\':  out << "\\\\";   break;
+         case '\"':  out << "\\\"";   break;
+         case '\b':  out << "\\b";    break;
+         case '\f':  out << "\\f";    break;
+         case '\n':  out << "\\n";    break;
+         case '\r':  out << "\\r";    break;
+         case '\t':  out << "\\t";    break;
+         case '/':   out << "\\/";    break;
+         default: {
+            char seq[6] = {'\\', 'u', '0', '0', hexDigits[(*ite >> 4) & 0xF], hexDigits[*ite & 0xF]};
+            out.write(seq, sizeof(seq));
+         } break;
+      }
+      ite++;
+   }
+   out.put('"');
 }
 
 static inline void writeSpace(SOStream& out, EncodingOption flag, int depth) {
@@ -159,6 +155,16 @@ static inline void writeSpace(SOStream& out, EncodingOption flag, int depth) {
    }
 }
 
+inline void JsonSerializer::writeMember(SOStream& out, const JsonObject::Member& member, bool& first, EncodingOption flag, int depth) {
+   if (!first)
+      out << ",";
+   first = false;
+   writeSpace(out, flag, depth);
+   writeString(out, member.first, flag);
+   out << (flag.getIndent() == 0 ? ":" : " : ");
+   writeJson(out, member.second.get(), flag, depth);
+}
+
 void JsonSerializer::writeJson(SOStream& out, const Json* ele, EncodingOption flag, int depth) {
    switch (ele->getType()) {
       case JsonType::JSON_NULL:
@@ -173,33 +179,33 @@ void JsonSerializer::writeJson(SOStream& out, const Json* ele, EncodingOption fl
          out << (((JsonBool*) ele)->value ? "true" : "false");
          break;
 
-      case JsonType::JSON_INTEGER:
-         out << to_string(((JsonInt*) ele)->value);
-         break;
+      case JsonType::JSON_INTEGER: {
+         char d[Number::MAX_INT_SIZE];
+         out.write(d, Number::formatInt(((JsonInt*) ele)->value, d));
+      } break;
 
       case JsonType::JSON_DOUBLE: {
-         char d[64];
-         snprintf(d, 63, "%#f", ((JsonDouble*) ele)->value);
-         out << std::string(d);
+         char d[Number::MAX_REAL_SIZE];
+         out.write(d, Number::formatReal(((JsonDouble*) ele)->value, flag.getRealPrec(), d));
       } break;
 
       case JsonType::JSON_STRING:
-         out << stringToJson(((JsonString*) ele)->value, flag);
+         writeString(out, ((JsonString*) ele)->value, flag);
          break;
 
       case JsonType::JSON_UUID:
-         out << stringToJson(((JsonUUID*) ele)->value.toString(), flag);
+         writeString(out, ((JsonUUID*) ele)->value.toString(), flag);
          break;
 
       case JsonType::JSON_BINARY:
-         out << stringToJson(((JsonBinary*) ele)->value->toHex(), flag);
+         writeString(out, ((JsonBinary*) ele)->value->toHex(), flag);
          break;
 
       case JsonType::JSON_ARRAY: {
          bool first = true;
          out << "[";
          depth++;
-         for (auto ite : static_cast<const JsonArray*>(ele)->value) {
+         for (const auto& ite : static_cast<const JsonArray*>(ele)->value) {
             if (!first)
                out << ",";
             first = false;
@@ -216,23 +222,14 @@ void JsonSerializer::writeJson(SOStream& out, const Json* ele, EncodingOption fl
          out << "{";
          depth++;
 
-         elladan::VMap<std::string, Json_t> sorted;
-         const elladan::VMap<std::string, Json_t>* map = &static_cast<const JsonObject*>(ele)->value;
-         if (flag.test(EF_JSON_SORT_KEY)) {
-            sorted = *map;
-            sorted.sort();
-            map = &sorted;
-         }
+         const JsonObject* obj = static_cast<const JsonObject*>(ele);
+         if (flag.test(EF_JSON_SORT_KEY))
+            for (const JsonObject::Member* ite : obj->sortedMembers())
+               writeMember(out, *ite, first, flag, depth);
+         else
+            for (const auto& ite : obj->value)
+               writeMember(out, ite, first, flag, depth);
 
-         for (auto ite : *map) {
-            if (!first)
-               out << ",";
-            first = false;
-            writeSpace(out, flag, depth);
-            out << stringToJson(ite.first, flag);
-            out << (flag.getIndent() == 0 ? ":" : " : ");
-            writeJson(out, ite.second.get(), flag, depth);
-         }
          depth--;
          writeSpace(out, flag, depth);
          out << "}";
@@ -244,184 +241,229 @@ void JsonSerializer::writeJson(SOStream& out, const Json* ele, EncodingOption fl
 }
 
 void JsonSerializer::write(std::ostream* out, const Json* data, EncodingOption flag) {
-   SOStream str(out);
+   StreamSink sink(out);
+   write(sink, data, flag);
+}
+
+void JsonSerializer::write(OutputSink& sink, const Json* data, EncodingOption flag) {
+   OutputBuffer buf(sink);
+   SOStream str(buf);
    writeJson(str, data, flag, 0);
+   buf.flush();
 }
 
 ///////////////////////////////////
 
-struct Pos {
-   size_t line;
-   size_t col;
-   void throwErr(const std::string& err) {
-      std::ostringstream str;
-      str << err << " at line " << line << " column " << col;
-      throw Exception(str.str());
-   }
-};
+JsonWriter::JsonWriter(std::ostream* out, EncodingOption flag) :
+   _stream(new StreamSink(out)), _out(*_stream), _flags(flag), _first(true), _hasKey(false) {
+}
 
-class SIStream {
-public:
-   class MngError {
-   public:
-      MngError(const std::string& err, bool skipWs, bool skipCom, SIStream& str) :
-         _err(err), _str(str), _skip_ws(skipWs), _skip_comment(skipCom) {
-      }
+JsonWriter::JsonWriter(OutputSink& out, EncodingOption flag) :
+   _out(out), _flags(flag), _first(true), _hasKey(false) {
+}
 
-      int operator >>(char& cur) {
-         do {
-            if (!(_str >> cur)) {
-               if (!_err.empty())
-                  _str.throwErr(_err);
-               return 0;
-            }
+// Same delimiters and spacing as writeJson().
+void JsonWriter::next() {
+   if (_open.empty())
+      return;
+   if (_open.back() == '{') {
+      if (!_hasKey)
+         throw Exception("Value without a key in an object");
+      _hasKey = false;
+      return;
+   }
 
-            if (_skip_comment && _str.flags.test(DecodingFlags::DF_IGNORE_COMMENT) && cur == '/') {
-               char prev = cur;
-               _str >> cur;
-
-               // '/*' comment : skip until '*/' is found.
-               if (cur == '*') {
-                  bool prev_is_star = false;
-                  do {
-                     _str >> cur;
-                     if (prev_is_star && cur == '/')
-                        break;
-                     prev_is_star = cur == '*';
-                  } while (1);
-                  _str >> cur;
-               }
+   SOStream out(_out);
+   if (!_first)
+      out << ",";
+   _first = false;
+   writeSpace(out, _flags, _open.size());
+}
 
-               // '//' comment : skip remaining of the line.
-               else if (cur == '/') {
-                  do {
-                     _str >> cur;
-                  } while (cur != '\n');
-                  _str >> cur;
-               }
+void JsonWriter::close(const char* end) {
+   if (_open.empty() || _open.back() != (*end == '}' ? '{' : '[') || _hasKey)
+      throw Exception(std::string("Unexpected ") + end);
+   _open.pop_back();
 
-               // Not a comment, keep last read character.
-               else {
-                  _str.pushBack(cur);
-                  cur = prev;
-               }
-            }
-         } while (_skip_ws && std::isspace(cur));
-         return 1;
-      }
-      std::string _err;
-      SIStream& _str;
-      bool _skip_ws;
-      bool _skip_comment;
-   };
+   SOStream out(_out);
+   writeSpace(out, _flags, _open.size());
+   out << end;
+   _first = false;
+   done();
+}
 
-   DecodingOption flags;
-   std::istream* iStr;
-   Pos pos;
+// Hand the document to the sink once the root value is complete.
+void JsonWriter::done() {
+   if (_open.empty())
+      _out.flush();
+}
 
-   SIStream(std::istream* in, DecodingOption flag) :
-      iStr(in), flags(flag) {
-      pos.line = 0;
-      pos.col = -1;
-      _last = '\0';
-   }
+void JsonWriter::onNull() {
+   next();
+   SOStream(_out) << "null";
+   done();
+}
+void JsonWriter::onBool(bool value) {
+   next();
+   SOStream(_out) << (value ? "true" : "false");
+   done();
+}
+void JsonWriter::onInt(int64_t value) {
+   next();
+   char d[Number::MAX_INT_SIZE];
+   SOStream(_out).write(d, Number::formatInt(value, d));
+   done();
+}
+void JsonWriter::onDouble(double value) {
+   next();
+   char d[Number::MAX_REAL_SIZE];
+   SOStream(_out).write(d, Number::formatReal(value, _flags.getRealPrec(), d));
+   done();
+}
+void JsonWriter::onString(const std::string& value) {
+   next();
+   SOStream out(_out);
+   JsonSerializer::writeString(out, value, _flags);
+   done();
+}
+void JsonWriter::onBinary(const Binary_t& value) {
+   next();
+   SOStream out(_out);
+   JsonSerializer::writeString(out, value->toHex(), _flags);
+   done();
+}
+void JsonWriter::onUUID(const elladan::UUID& value) {
+   next();
+   SOStream out(_out);
+   JsonSerializer::writeString(out, value.toString(), _flags);
+   done();
+}
 
-   void throwErr(const std::string& err) {
-      pos.throwErr(err);
-   }
+void JsonWriter::onKey(const std::string& key) {
+   if (_open.empty() || _open.back() != '{' || _hasKey)
+      throw Exception("Key " + key + " outside of an object");
+   _hasKey = true;
+
+   SOStream out(_out);
+   if (!_first)
+      out << ",";
+   _first = false;
+   writeSpace(out, _flags, _open.size());
+   JsonSerializer::writeString(out, key, _flags);
+   out << (_flags.getIndent() == 0 ? ":" : " : ");
+}
 
-   MngError operator()(std::string err = "", bool skipWs = true, bool skipCom = true) {
-      if (!err.empty())
-         err = std::string("Unexpected EOF while ") + err;
-      return MngError(err, skipWs, skipCom, *this);
-   }
+void JsonWriter::onStartObject() {
+   next();
+   SOStream(_out) << "{";
+   _open.push_back('{');
+   _first = true;
+}
+void JsonWriter::onEndObject() {
+   close("}");
+}
 
-   inline void pushBack(char c) {
-      _last = c;
-   }
+void JsonWriter::onStartArray() {
+   next();
+   SOStream(_out) << "[";
+   _open.push_back('[');
+   _first = true;
+}
+void JsonWriter::onEndArray() {
+   close("]");
+}
 
-   int operator >>(char& c) {
-      if (_last) {
-         c = _last;
-         _last = 0;
-         return 1;
-      }
+///////////////////////////////////
 
-      else {
-         iStr->read(&c, 1);
-         pos.col++;
-         if (c == '\n') {
-            pos.line++;
-            pos.col = 0;
-         }
-         return iStr->gcount();
-      }
+// Read the 4 hex digits following \u.
+static int readUnicodeEscape(SIStream& in) {
+   int sum = 0;
+   char letter;
+   for (int i = 0; i < 4; i++) {
+      in("decoding UTF encoded char", false, false) >> letter;
+      int digit = hexValue(letter);
+      if (digit < 0)
+         in.throwErr("Invalid unicode escape");
+      sum = (sum << 4) | digit;
    }
+   return sum;
+}
 
-protected:
-   friend class MngError;
-   char _last;
-
-};
+// Read the code point of a \u escape, surrogate pairs included.
+static int readCodePoint(SIStream& in) {
+   char letter;
+   int sum = readUnicodeEscape(in);
+
+   // Lone low surrogate.
+   if (sum >= 0xDC00 && sum < 0xE000)
+      in.throwErr("Invalid unicode escape");
+
+   // High surrogate, must be followed by an escaped low surrogate.
+   if (sum >= 0xD800 && sum < 0xDC00) {
+      in("decoding UTF encoded char", false, false) >> letter;
+      if (letter != '\\')
+         in.throwErr("Invalid unicode escape");
+      in("decoding UTF encoded char", false, false) >> letter;
+      if (letter != 'u')
+         in.throwErr("Invalid unicode escape");
+
+      int sum2 = readUnicodeEscape(in);
+      if (sum2 < 0xDC00 || sum2 >= 0xE000)
+         in.throwErr("Invalid unicode escape");
+
+      sum = ((sum - 0xD800) << 10) + (sum2 - 0xDC00) + 0x10000;
+   }
+   return sum;
+}
 
-std::string JsonSerializer::jsonToString(SIStream& in) {
-   std::string retVal;
+void JsonSerializer::jsonToString(SIStream& in, std::string& retVal) {
    char letter;
+   retVal.clear();
+   const char* begin;
+   const char* end;
 
    do {
-      in("Could not decode string : Unexpected end of file.", false) >> letter;
+      // Append the run of plain characters in one go.
+      if (in.buffered(begin, end)) {
+         const char* special = StringScan::findSpecial(begin, end);
+         retVal.append(begin, special);
+
+         // Plain end of string.
+         if (special < end && *special == '"') {
+            in.skip(special + 1);
+            return;
+         }
+         in.skip(special);
+      }
+
+      in("Could not decode string : Unexpected end of file.", false, false) >> letter;
       switch (letter) {
          case '\\': {
-            in("decoding escaped char") >> letter;
+            in("decoding escaped char", false, false) >> letter;
 
             switch (letter) {
-               case '"':    retVal += "\"";  break;
-               case '/':    retVal += "/";   break;
-               case '\\':   retVal += "\\";  break;
-               case 'b':    retVal += "\b";  break;
-               case 'f':    retVal += "\f";  break;
-               case 'n':    retVal += "\n";  break;
-               case 'r':    retVal += "\r";  break;
-               case 't':    retVal += "\t";  break;
+               case '"':    retVal.push_back('"');   break;
+               case '/':    retVal.push_back('/');   break;
+               case '\\':   retVal.push_back('\\');  break;
+               case 'b':    retVal.push_back('\b');  break;
+               case 'f':    retVal.push_back('\f');  break;
+               case 'n':    retVal.push_back('\n');  break;
+               case 'r':    retVal.push_back('\r');  break;
+               case 't':    retVal.push_back('\t');  break;
                case '0':
                   if (!in.flags.test(DecodingFlags::DF_ALLOW_NULL))
                      in.throwErr("Found null value in string");
-                  retVal += "\0";
+                  retVal.push_back('\0');
                   break;
 
                case 'u': {
-                  int sum = 0;
-                  std::string val;
-                  for (int i = 0; i < 4; i++) {
-                     in("decoding UTF encoded char") >> letter;
-                     val.push_back(letter);
-                  }
-                  sum = std::stoi(val, 0, 16);
-
-                  if (sum >= 0xDC00)
-                     in.throwErr("Invalid unicode escape");
-
-                  if (sum >= 0xD800) {
-                     val.clear();
-                     for (int i = 0; i < 4; i++) {
-                        in("decoding UTF encoded char") >> letter;
-                        val.push_back(letter);
-                     }
-                     int sum2 = std::stoi(val, 0, 16);
+                  int sum = readCodePoint(in);
 
-                     if (sum2 < 0xDC00)
-                        in.throwErr("Invalid unicode escape");
-
-                     sum = ((sum - 0xD800) << 10) + (sum2 - 0xDC00) + 0x10000;
-                  }
-
-                  char unicode[9];
+                  char unicode[4];
                   size_t length;
                   if (Utf8::encode(sum, unicode, &length))
                      in.throwErr("Could not process unicode");
-
-                  unicode[length] = '\0';
-                  retVal += unicode;
+                  retVal.append(unicode, length);
                }
                break;
 
@@ -434,7 +476,7 @@ std::string JsonSerializer::jsonToString(SIStream& in) {
 
          case '"':
             // End of string.
-            return retVal;
+            return;
 
          case '\0':
             if (!in.flags.test(DecodingFlags::DF_ALLOW_NULL))
@@ -447,134 +489,731 @@ std::string JsonSerializer::jsonToString(SIStream& in) {
    } while (1);
 }
 
-Json_t JsonSerializer::readJson(SIStream& in, char cur) {
-   std::string str;
-   str.reserve(32);
-
-   // Object
-   if (cur == '{') {
-      JsonObject_t obj = std::make_shared<JsonObject>();
+void JsonSerializer::skipString(SIStream& in) {
+   char letter;
+   const char* begin;
+   const char* end;
 
-      in("looking for the end of the object") >> cur;
-      while (cur != '}') {
+   do {
+      if (in.buffered(begin, end)) {
+         const char* special = StringScan::findSpecial(begin, end);
+         if (special < end && *special == '"') {
+            in.skip(special + 1);
+            return;
+         }
+         in.skip(special);
+      }
 
-         // Get the key.
-         Pos startOFLine = in.pos;
-         JsonString_t key = std::dynamic_pointer_cast<JsonString>(readJson(in, cur));
-         if (!key)
-            startOFLine.throwErr("Missing key");
+      in("Could not decode string : Unexpected end of file.", false, false) >> letter;
+      switch (letter) {
+         case '\\':
+            in("decoding escaped char", false, false) >> letter;
+            switch (letter) {
+               case '"': case '/': case '\\': case 'b': case 'f': case 'n': case 'r': case 't':
+                  break;
+               case '0':
+                  if (!in.flags.test(DecodingFlags::DF_ALLOW_NULL))
+                     in.throwErr("Found null value in string");
+                  break;
+               case 'u':
+                  readCodePoint(in);
+                  break;
+               default:
+                  in.throwErr("Invalid escape");
+                  break;
+            }
+            break;
 
-         if (in.flags.test(DecodingFlags::DF_REJECT_DUPLICATE) && obj->value.count(key->value))
-            in.throwErr("Duplicate value");
+         case '"':
+            return;
 
-         // Get ":"
-         in("looking for key value delimiter \':\'") >> cur;
-         if (cur == ':')
-            in("looking for object value") >> cur;
-         else if (!in.flags.test(DecodingFlags::DF_ALLOW_COMMA_ERR))
-            in.throwErr("Expecting array key value delimiter \":\"");
+         case '\0':
+            if (!in.flags.test(DecodingFlags::DF_ALLOW_NULL))
+               in.throwErr("Found null value in string");
+            break;
 
-         // Read the associated value.
-         Json_t child = readJson(in, cur);
-         if (!child)
-            in.throwErr("File ended before getting the value");
-         obj->value[key->value] = child;
-
-         // Check if there is are remaining values,
-         in("looking for element delimiter \',\' or closing bracket \'}\'") >> cur;
-         if (cur == ',')
-            in("looking for object next object element") >> cur;
-         else if (cur != '}' && !in.flags.test(DecodingFlags::DF_ALLOW_COMMA_ERR))
-            in.throwErr("Expected an element delimiter \',\'");
+         default:
+            break;
       }
+   } while (1);
+}
 
-      return obj;
-   }
+// Get the whole "word" starting with cur, only long words end up on the heap.
+struct Word {
+   char buf[64];
+   std::string longWord;
+   const char* text;
+   size_t len;
 
-   // Array
-   if (cur == '[') {
-      JsonArray_t obj = std::make_shared<JsonArray>();
+   Word(SIStream& in, char cur) : text(buf), len(0) {
+      do {
+         if (!isWordChar(cur))
+            break;
+
+         if (len == sizeof(buf)) {
+            longWord.append(buf, len);
+            len = 0;
+         }
+         buf[len++] = cur;
+      } while ((in >> cur) > 0);
 
-      in("while looking for end of array") >> cur;
-      while (cur != ']') {
-         // Read the associated value.
-         Json_t child = readJson(in, cur);
-         if (!child)
-            in.throwErr("File ended before getting the value");
-         obj->value.push_back(child);
+      in.pushBack(cur);
 
-         // Check if there is are remaining values,
-         in("looking for element delimiter \',\' or closing bracket \']\'") >> cur;
-         if (cur == ',')
-            in("looking for object next array element") >> cur;
-         else if (cur != ']' && !(in.flags.test(DecodingFlags::DF_ALLOW_COMMA_ERR)))
-            in.throwErr("Expected an element delimiter \',\'");
+      if (!longWord.empty()) {
+         longWord.append(buf, len);
+         text = longWord.c_str();
+         len = longWord.size();
       }
 
-      return obj;
+      if (len == 0)
+         in.throwErr("Expected value, nothing found");
    }
+};
 
-   // String
-   if (cur == '"')
-      return std::make_shared<JsonString>(jsonToString(in));
+void JsonSerializer::parseKey(SIStream& in, char& cur, JsonHandler& handler) {
+   if (cur != '"')
+      in.throwErr("Missing key");
+   jsonToString(in, in.scratch);
 
-   // Something else?
+   // The handler may reject the key (duplicate, ...), report it where it was found.
+   try {
+      handler.onKey(in.scratch);
+   }
+   catch (Exception& e) {
+      in.throwErr(e.what());
+   }
+
+   // Get ":"
+   in("looking for key value delimiter \':\'") >> cur;
+   if (cur == ':')
+      in("looking for object value") >> cur;
+   else if (!in.flags.test(DecodingFlags::DF_ALLOW_COMMA_ERR))
+      in.throwErr("Expecting array key value delimiter \":\"");
+}
 
-   // Get the whole "word"
-   std::string word;
+void JsonSerializer::parseJson(SIStream& in, char cur, JsonHandler& handler) {
+   // No recursion : the open containers are kept in in.nesting, the ones below `base` belong to the caller.
+   size_t base = in.nesting.size();
 
    do {
-      // Make sure if fit out permitted list.
-      cur = tolower(cur);
+      // Object or array
+      if (cur == '{' || cur == '[') {
+         bool isObject = cur == '{';
+         in.open(cur);
+         if (isObject) {
+            handler.onStartObject();
+            in("looking for the end of the object") >> cur;
+         }
+         else {
+            handler.onStartArray();
+            in("while looking for end of array") >> cur;
+         }
 
-      static const std::string validChar = "0123456789abcdefgyijklmnopqrstuvwxyz-.";
-      if (validChar.find(cur) == std::string::npos)
-         break;
+         // Not empty : go on with its first value.
+         if (cur != (isObject ? '}' : ']')) {
+            if (isObject)
+               parseKey(in, cur, handler);
+            continue;
+         }
 
-      str.push_back(cur);
-   } while ((in >> cur) > 0);
+         in.nesting.pop_back();
+         if (isObject)
+            handler.onEndObject();
+         else
+            handler.onEndArray();
+      }
 
-   in.pushBack(cur);
+      // String
+      else if (cur == '"') {
+         jsonToString(in, in.scratch);
+         handler.onString(in.scratch);
+      }
 
-   if (str.empty())
-      in.throwErr("Expected value, nothing found");
+      // Something else?
+      else {
+         Word word(in, cur);
+         if (!readWord(word.text, word.len, in.flags, handler))
+            in.throwErr("Could not identity type of " + std::string(word.text, word.len));
+      }
 
-   if (str == "null" && (in.flags.test(DecodingFlags::DF_ALLOW_NULL)))
-      return std::make_shared<JsonNull>();
+      // The value is done : get the next one, closing the containers that ends here.
+      while (in.nesting.size() > base) {
+         if (in.nesting.back() == '{') {
+            // Check if there is are remaining values,
+            in("looking for element delimiter \',\' or closing bracket \'}\'") >> cur;
+            if (cur == ',')
+               in("looking for object next object element") >> cur;
+            else if (cur != '}' && !in.flags.test(DecodingFlags::DF_ALLOW_COMMA_ERR))
+               in.throwErr("Expected an element delimiter \',\'");
+
+            if (cur != '}') {
+               parseKey(in, cur, handler);
+               break;
+            }
+            handler.onEndObject();
+         }
+         else {
+            in("looking for element delimiter \',\' or closing bracket \']\'") >> cur;
+            if (cur == ',')
+               in("looking for object next array element") >> cur;
+            else if (cur != ']' && !(in.flags.test(DecodingFlags::DF_ALLOW_COMMA_ERR)))
+               in.throwErr("Expected an element delimiter \',\'");
+
+            if (cur != ']')
+               break;
+            handler.onEndArray();
+         }
+         in.nesting.pop_back();
+      }
+   } while (in.nesting.size() > base);
+}
 
-   long int asInt;
-   if (parseString(str, asInt) == str.size())
-      return std::make_shared<JsonInt>(asInt);
+Json_t JsonSerializer::readJson(SIStream& in, char cur) {
+   JsonBuilder builder(in.flags);
+   parseJson(in, cur, builder);
+   return builder.get();
+}
 
+// Characters skipJson() has to look at.
+static inline bool isSkipSpecial(char c) {
+   switch (c) {
+      case '"': case '{': case '}': case '[': case ']': case '/':
+         return true;
+      default:
+         return false;
+   }
+}
+
+void JsonSerializer::skipJson(SIStream& in, char cur) {
+   if (cur == '"') {
+      skipString(in);
+      return;
+   }
+
+   if (cur != '{' && cur != '[') {
+      // The base handler ignores the value, it is only checked.
+      JsonHandler ignore;
+      Word word(in, cur);
+      if (!readWord(word.text, word.len, in.flags, ignore))
+         in.throwErr("Could not identity type of " + std::string(word.text, word.len));
+      return;
+   }
+
+   // Objects and arrays are skipped in bulk. Only the brackets and the strings are checked,
+   // a broken value in between is reported once it is really decoded.
+   size_t base = in.nesting.size();
+   in.open(cur);
+   const char* begin;
+   const char* end;
+
+   do {
+      if (!in.buffered(begin, end))
+         in.throwErr("Unexpected EOF while skipping value");
+
+      const char* p = begin;
+      while (p < end && !isSkipSpecial(*p))
+         p++;
+      in.skip(p);
+      if (p == end)
+         continue;
+
+      in >> cur;
+      switch (cur) {
+         case '"':
+            skipString(in);
+            break;
+
+         case '{':
+         case '[':
+            in.open(cur);
+            break;
+
+         case '}':
+         case ']':
+            if (cur != (in.nesting.back() == '{' ? '}' : ']'))
+               in.throwErr("Unexpected closing bracket");
+            in.nesting.pop_back();
+            if (in.nesting.size() == base)
+               return;
+            break;
+
+         case '/':
+            // Only a comment may start with a '/' out of the strings.
+            if (!in.flags.test(DecodingFlags::DF_IGNORE_COMMENT) || !in("skipping value").skipComment())
+               in.throwErr("Unexpected character \'/\'");
+            break;
+      }
+   } while (1);
+}
+
+// Case insensitive comparison with a lower case word.
+static inline bool isWord(const char* text, size_t len, const char* word, size_t wordLen) {
+   if (len != wordLen)
+      return false;
+   for (size_t i = 0; i < len; i++)
+      if ((text[i] | 0x20) != word[i])
+         return false;
+   return true;
+}
+
+bool JsonSerializer::readWord(const char* text, size_t len, DecodingOption flag, JsonHandler& handler) {
+   int64_t asInt;
    double asDouble;
-   if (parseString(str, asDouble) == str.size())
-      return std::make_shared<JsonDouble>(asDouble);
+   switch (Number::parse(text, text + len, asInt, asDouble)) {
+      case Number::INTEGER:   handler.onInt(asInt);       return true;
+      case Number::REAL:      handler.onDouble(asDouble); return true;
+      default:                break;
+   }
+
+   if (isWord(text, len, "null", 4)) {
+      if (!flag.test(DecodingFlags::DF_ALLOW_NULL))
+         return false;
+      handler.onNull();
+      return true;
+   }
+   if (isWord(text, len, "true", 4)) {
+      handler.onBool(true);
+      return true;
+   }
+   if (isWord(text, len, "false", 5)) {
+      handler.onBool(false);
+      return true;
+   }
 
+   // Whatever else is understood as a boolean.
+   std::string str(text, len);
+   std::transform(str.begin(), str.end(), str.begin(), ::tolower);
    bool asBool;
-   if (parseString(str, asBool))
-      return std::make_shared<JsonBool>(asBool);
+   if (!parseString(str, asBool))
+      return false;
+   handler.onBool(asBool);
+   return true;
+}
+
+///////////////////////////////////
+
+// Thrown when the indexed parser meet anything it does not handle, the sequential parser take over.
+struct IndexFallback {};
+
+/**
+ * Second pass of the two pass parser : build the tree from the structural index.
+ * Only strict json is handled here. Anything else (errors, comma errors, ...) fall back
+ * to the sequential parser so the result and the error reported are the same.
+ */
+class JsonIndexParser {
+public:
+   // Parse the index entries [begin, end), the input stops at data + size. The value is inside `depth` containers.
+   JsonIndexParser(const char* data, size_t size, const uint32_t* begin, const uint32_t* end, JsonHandler& handler, DecodingOption flag, size_t depth = 0) :
+      _data(data), _size(size), _cur(begin), _end(end), _handler(handler), _flags(flag), _depth(depth) {
+   }
+
+   void parse() {
+      if (_cur != _end)
+         readValue(next());
+   }
+
+   // True if every index entry was used.
+   bool done() const {
+      return _cur == _end;
+   }
+
+protected:
+   inline const char* next() {
+      if (_cur == _end)
+         throw IndexFallback();
+      return _data + *_cur++;
+   }
+
+   // Too deep, the sequential parser reports it.
+   inline void open() {
+      if (++_depth > _flags.getMaxDepth())
+         throw IndexFallback();
+   }
+
+   // The open containers are kept in a local stack, not on the call stack.
+   void readValue(const char* p) {
+      std::string nesting;
+
+      do {
+         // p starts a value, a container is entered.
+         switch (*p) {
+            case '{':
+               open();
+               _handler.onStartObject();
+               p = next();
+               if (*p != '}') {
+                  nesting.push_back('{');
+                  readKey(p);
+                  p = next();
+                  continue;
+               }
+               _handler.onEndObject();
+               _depth--;
+               break;
+
+            case '[':
+               open();
+               _handler.onStartArray();
+               p = next();
+               if (*p != ']') {
+                  nesting.push_back('[');
+                  continue;
+               }
+               _handler.onEndArray();
+               _depth--;
+               break;
+
+            case '"':
+               _handler.onString(readString(p));
+               break;
+
+            case '}':
+            case ']':
+            case ',':
+            case ':':
+               throw IndexFallback();
+
+            default:
+               readWord(p);
+               break;
+         }
+
+         // The value is done, close the containers it ends and move to the next element.
+         while (!nesting.empty()) {
+            p = next();
+            if (*p == ',') {
+               p = next();
+               if (nesting.back() == '{') {
+                  readKey(p);
+                  p = next();
+               }
+               break;
+            }
+
+            if (nesting.back() == '{') {
+               if (*p != '}')
+                  throw IndexFallback();
+               _handler.onEndObject();
+            }
+            else {
+               if (*p != ']')
+                  throw IndexFallback();
+               _handler.onEndArray();
+            }
+            _depth--;
+            nesting.pop_back();
+         }
+      } while (!nesting.empty());
+   }
+
+   // Object key and its delimiter, the value follows.
+   void readKey(const char* p) {
+      if (*p != '"')
+         throw IndexFallback();
+      _handler.onKey(readString(p));
+
+      if (*next() != ':')
+         throw IndexFallback();
+   }
+
+   std::string readString(const char* open) {
+      const char* close = next();
+      if (*close != '"')
+         throw IndexFallback();
+
+      size_t len = close - open - 1;
+      if (!memchr(open + 1, '\\', len) && !memchr(open + 1, '\0', len))
+         return std::string(open + 1, len);
+
+      // Escaped string, let the sequential decoder handle it. It must stop on the indexed closing quote.
+      SIStream in(open + 1, len + 1, _flags);
+      std::string retVal;
+      char cur;
+      try {
+         JsonSerializer::jsonToString(in, retVal);
+      }
+      catch (std::exception&) {
+         throw IndexFallback();
+      }
+      if (in >> cur)
+         throw IndexFallback();
+      return retVal;
+   }
+
+   void readWord(const char* p) {
+      const char* lim = _data + (_cur == _end ? _size : *_cur);
+      const char* word = p;
+      while (p < lim && isWordChar(*p))
+         p++;
+
+      // The word must be followed by a white space or a structural character.
+      if (p == word || (p < lim && !std::isspace(*p)))
+         throw IndexFallback();
+
+      if (!JsonSerializer::readWord(word, p - word, _flags, _handler))
+         throw IndexFallback();
+   }
+
+   const char* _data;
+   size_t _size;
+   const uint32_t* _cur;
+   const uint32_t* _end;
+   JsonHandler& _handler;
+   DecodingOption _flags;
+   size_t _depth;
+};
 
-   in.throwErr("Could not identity type of " + str);
-   return Json_t();
+// The structural index need the whole input, comments can't be indexed.
+static inline bool useIndex(DecodingOption flag) {
+   return flag.test(DecodingFlags::DF_STRUCTURAL_INDEX) && !flag.test(DecodingFlags::DF_IGNORE_COMMENT);
 }
 
-Json_t JsonSerializer::read(std::istream* in_stream, DecodingOption flag) {
-   SIStream in(in_stream, flag);
+// The parallel parser cut the input with the structural index.
+static inline bool useParallel(DecodingOption flag) {
+   return flag.test(DecodingFlags::DF_PARALLEL) && !flag.test(DecodingFlags::DF_IGNORE_COMMENT);
+}
+
+Json_t JsonSerializer::parseIndexed(const char* data, size_t size, DecodingOption flag) {
+   std::vector<uint32_t> index;
+   if (StructuralIndex::build(data, size, index)) {
+      try {
+         JsonBuilder builder(flag);
+         JsonIndexParser parser(data, size, index.data(), index.data() + index.size(), builder, flag);
+         parser.parse();
+         return builder.get();
+      }
+      catch (IndexFallback&) {
+      }
+      catch (Exception&) {
+      }
+   }
+
+   SIStream in(data, size, flag);
+   return readRoot(in);
+}
+
+Json_t JsonSerializer::parseParallel(const char* data, size_t size, DecodingOption flag) {
+   std::vector<uint32_t> index;
+   if (!StructuralIndex::build(data, size, index) || index.empty() || data[index[0]] != '[') {
+      if (useIndex(flag))
+         return parseIndexed(data, size, flag);
+      SIStream in(data, size, flag);
+      return readRoot(in);
+   }
+
+   // Index entries of the opening bracket, the top level commas and the closing bracket.
+   std::vector<size_t> bounds;
+   int depth = 0;
+   for (size_t i = 0; i < index.size(); i++) {
+      char c = data[index[i]];
+      if (c == '[' || c == '{') {
+         if (depth++ == 0)
+            bounds.push_back(i);
+      }
+      else if (c == ']' || c == '}') {
+         if (--depth == 0) {
+            bounds.push_back(i);
+            break;
+         }
+      }
+      else if (c == ',' && depth == 1)
+         bounds.push_back(i);
+   }
 
+   size_t count = bounds.size() - 1;
+   bool indexed = flag.test(DecodingFlags::DF_STRUCTURAL_INDEX);
+   JsonArray_t retVal = std::make_shared<JsonArray>();
+
+   try {
+      if (depth != 0 || data[index[bounds.back()]] != ']')
+         throw IndexFallback();
+
+      // Nothing between the brackets.
+      if (count == 1 && bounds[0] + 1 == bounds[1])
+         return retVal;
+
+      retVal->value.resize(count);
+      size_t tasks = std::min<size_t>(count, Parallel::threadCount(0) * 8);
+      size_t perTask = (count + tasks - 1) / tasks;
+
+      Parallel::run(tasks, 0, [&](size_t task) {
+         size_t last = std::min(count, (task + 1) * perTask);
+         for (size_t k = task * perTask; k < last; k++) {
+            const char* begin = data + index[bounds[k]] + 1;
+            const char* end = data + index[bounds[k + 1]];
+
+            if (indexed) {
+               try {
+                  JsonBuilder builder(flag);
+                  JsonIndexParser parser(data, end - data, index.data() + bounds[k] + 1, index.data() + bounds[k + 1], builder, flag, 1);
+                  parser.parse();
+                  if (parser.done() && builder.get()->getType() != JSON_NONE) {
+                     retVal->value[k] = builder.get();
+                     continue;
+                  }
+               }
+               catch (IndexFallback&) {
+               }
+               catch (Exception&) {
+               }
+            }
+
+            // The element must be the only thing between its delimiters. It is inside the top level array.
+            SIStream in(begin, end - begin, flag);
+            in.nesting.assign(1, '[');
+            char cur;
+            if (!(in() >> cur))
+               throw IndexFallback();
+            retVal->value[k] = readJson(in, cur);
+            if (in() >> cur)
+               throw IndexFallback();
+         }
+      });
+   }
+   // Let the sequential parser deal with anything unexpected, it gives the right error and position.
+   catch (IndexFallback&) {
+      SIStream in(data, size, flag);
+      return readRoot(in);
+   }
+   catch (std::exception&) {
+      SIStream in(data, size, flag);
+      return readRoot(in);
+   }
+
+   return retVal;
+}
+
+Json_t JsonSerializer::readRoot(SIStream& in) {
    char cur;
-   if (!(in("") >> cur))
+   if (!(in() >> cur))
       return std::make_shared<Json>();
    return readJson(in, cur);
 }
 
+Json_t JsonSerializer::read(std::istream* in_stream, DecodingOption flag) {
+   if (useIndex(flag) || useParallel(flag)) {
+      std::ostringstream str;
+      str << in_stream->rdbuf();
+      const std::string& data = str.str();
+      return parse(data.c_str(), data.size(), flag);
+   }
+
+   SIStream in(in_stream, flag);
+   return readRoot(in);
+}
+
+Json_t JsonSerializer::parse(const char* data, size_t size, DecodingOption flag) {
+   if (useParallel(flag))
+      return parseParallel(data, size, flag);
+   if (useIndex(flag))
+      return parseIndexed(data, size, flag);
+
+   SIStream in(data, size, flag);
+   return readRoot(in);
+}
+
+void JsonSerializer::read(std::istream* in_stream, JsonHandler& handler, DecodingOption flag) {
+   SIStream in(in_stream, flag);
+
+   char cur;
+   if (in() >> cur)
+      parseJson(in, cur, handler);
+}
+
+void JsonSerializer::parse(const char* data, size_t size, JsonHandler& handler, DecodingOption flag) {
+   SIStream in(data, size, flag);
+
+   char cur;
+   if (in() >> cur)
+      parseJson(in, cur, handler);
+}
+
+// Same path rules as Json::getChild(), only the matching values are decoded.
+void JsonSerializer::searchJson(SIStream& in, char cur, size_t deepness, const std::vector<std::string>& parts, std::vector<Json_t>& retVal) {
+   // Path part and next array index of each container entered, kept here rather than on the call stack.
+   std::vector<std::pair<size_t, size_t>> levels;
+   std::string name;
+   bool match = true;
+
+   do {
+      // cur starts a value : decode, enter or skip it.
+      bool entered = false;
+      if (match && deepness >= parts.size())
+         // We are past the path parts : this is the one we are looking for.
+         retVal.push_back(readJson(in, cur));
+      else if (match && (cur == '{' || cur == '[')) {
+         in.open(cur);
+         levels.emplace_back(deepness, 0);
+         in("looking for the end of the container") >> cur;
+         entered = true;
+      }
+      else
+         skipJson(in, cur);
+
+      // Move to the next element, closing the containers ended on the way.
+      while (!levels.empty()) {
+         char close = in.nesting.back() == '{' ? '}' : ']';
+         if (!entered) {
+            in("looking for element delimiter \',\' or closing bracket") >> cur;
+            if (cur == ',')
+               in("looking for next element") >> cur;
+            else if (cur != close && !in.flags.test(DecodingFlags::DF_ALLOW_COMMA_ERR))
+               in.throwErr("Expected an element delimiter \',\'");
+         }
+         if (cur != close)
+            break;
+         in.nesting.pop_back();
+         levels.pop_back();
+         entered = false;
+      }
+      if (levels.empty())
+         return;
+
+      // Object key or array index.
+      if (in.nesting.back() == '{') {
+         if (cur != '"')
+            in.throwErr("Missing key");
+         jsonToString(in, name);
+
+         in("looking for key value delimiter \':\'") >> cur;
+         if (cur == ':')
+            in("looking for object value") >> cur;
+         else if (!in.flags.test(DecodingFlags::DF_ALLOW_COMMA_ERR))
+            in.throwErr("Expecting array key value delimiter \":\"");
+      }
+      else
+         name = std::to_string(levels.back().second++);
+
+      deepness = levels.back().first;
+      size_t inc = 1;
+      if (parts[deepness] == "**") {
+         match = true;
+         inc = 2 * (deepness + 1 < parts.size() && parts[deepness + 1] == name);
+      }
+      else
+         match = parts[deepness] == "*" || parts[deepness] == name;
+      deepness += inc;
+   } while (1);
+}
+
 std::vector<Json_t> JsonSerializer::extract(std::istream* in_stream, DecodingOption flag, const std::string& path) {
    SIStream in(in_stream, flag);
+   std::vector<Json_t> retVal;
 
    char cur;
-   if (!(in("") >> cur))
-      return std::vector<Json_t>();
+   if (in() >> cur)
+      searchJson(in, cur, 1, tokenize(path, "/"), retVal);
+   return retVal;
+}
 
-   return Json::getChild(readJson(in, cur), path);
+std::vector<Json_t> JsonSerializer::extract(const char* data, size_t size, DecodingOption flag, const std::string& path) {
+   SIStream in(data, size, flag);
+   std::vector<Json_t> retVal;
+
+   char cur;
+   if (in() >> cur)
+      searchJson(in, cur, 1, tokenize(path, "/"), retVal);
+   return retVal;
 }
 
 }
@@ -15,20 +15,51 @@
 namespace elladan { namespace json {
 
 class SOStream;
+class OutputSink;
 class SIStream;
+class JsonHandler;
+class JsonDocument;
+class JsonIndexParser;
+class JsonReader;
+class JsonLines;
+class JsonPushParser;
+class JsonWriter;
 
 class JsonSerializer
 {
 public:
     static void write(std::ostream* out, const Json* data, EncodingOption flag);
+    static void write(OutputSink& out, const Json* data, EncodingOption flag);
     static Json_t read(std::istream* in, DecodingOption flag);
+    static Json_t parse(const char* data, size_t size, DecodingOption flag);
+    static void read(std::istream* in, JsonHandler& handler, DecodingOption flag);
+    static void parse(const char* data, size_t size, JsonHandler& handler, DecodingOption flag);
     static std::vector<Json_t> extract(std::istream* in, DecodingOption flag, const std::string& path);
+    static std::vector<Json_t> extract(const char* data, size_t size, DecodingOption flag, const std::string& path);
 
 protected:
+    friend class JsonDocument;
+    friend class JsonIndexParser;
+    friend class JsonReader;
+    friend class JsonLines;
+    friend class JsonPushParser;
+    friend class JsonWriter;
+
+    static Json_t readRoot(SIStream& in);
     static Json_t readJson(SIStream& in, char cur);
+    static void parseKey(SIStream& in, char& cur, JsonHandler& handler);
+    static void parseJson(SIStream& in, char cur, JsonHandler& handler);
+    static void skipJson(SIStream& in, char cur);
+    static void searchJson(SIStream& in, char cur, size_t deepness, const std::vector<std::string>& parts, std::vector<Json_t>& retVal);
+    static bool readWord(const char* text, size_t len, DecodingOption flag, JsonHandler& handler);
+    static Json_t parseIndexed(const char* data, size_t size, DecodingOption flag);
+    static Json_t parseParallel(const char* data, size_t size, DecodingOption flag);
     static void writeJson(SOStream& out, const Json* ele, EncodingOption flag, int depth);
-    static std::string stringToJson(const std::string& txt, EncodingOption flag);
-    static std::string jsonToString(SIStream& in);
+    static inline void writeMember(SOStream& out, const JsonObject::Member& member, bool& first, EncodingOption flag, int depth);
+    static void writeString(SOStream& out, const std::string& txt, EncodingOption flag);
+    // Decode the string following '"' into retVal.
+    static void jsonToString(SIStream& in, std::string& retVal);
+    static void skipString(SIStream& in);
 };
 
 } } // namespace elladan::json
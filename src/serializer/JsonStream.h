@@ -0,0 +1,256 @@
+/*
+ * JsonStream.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: daniel
+ */
+
+#pragma once
+
+#include <elladan/Exception.h>
+#include <elladan/FlagSet.h>
+#include <stddef.h>
+#include <cctype>
+#include <cstring>
+#include <istream>
+#include <memory>
+#include <sstream>
+#include <string>
+
+#include "../json.h"
+
+namespace elladan { namespace json {
+
+// Input side of the text serializer, shared by the decoders and the JsonReader.
+
+// Characters that can be part of a number, true, false, null, ...
+static inline bool isWordChar(char c) {
+   return (c >= '0' && c <= '9') || ((c | 0x20) >= 'a' && (c | 0x20) <= 'z') || c == '-' || c == '+' || c == '.';
+}
+
+static inline int hexValue(char c) {
+   if (c >= '0' && c <= '9') return c - '0';
+   c |= 0x20;
+   if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+   return -1;
+}
+
+struct Pos {
+   size_t line;
+   size_t col;
+   void throwErr(const std::string& err) const {
+      std::ostringstream str;
+      str << err << " at line " << line << " column " << col;
+      throw Exception(str.str());
+   }
+};
+
+/**
+ * Character input of the text decoders.
+ * Nothing is allocated while reading: the error messages are only built when they are thrown and
+ * the line/column are computed back from the read position when an error is reported.
+ */
+class SIStream {
+public:
+   class MngError {
+   public:
+      MngError(const char* err, bool skipWs, bool skipCom, SIStream& str) :
+         _err(err), _str(str), _skip_ws(skipWs), _skip_comment(skipCom) {
+      }
+
+      int operator >>(char& cur) {
+         while (_str >> cur) {
+            if (_skip_comment && cur == '/' && _str.flags.test(DecodingFlags::DF_IGNORE_COMMENT)) {
+               // Not a comment, keep the '/'.
+               if (!skipComment())
+                  return 1;
+               continue;
+            }
+            if (!_skip_ws || !std::isspace(cur))
+               return 1;
+         }
+
+         if (_err && *_err)
+            _str.throwErr(std::string("Unexpected EOF while ") + _err);
+         return 0;
+      }
+
+      // Skip the comment following a '/'. Return false if it is not a comment.
+      bool skipComment() {
+         char cur;
+         if (!(_str >> cur))
+            return false;
+
+         // '/*' comment : skip until '*/' is found.
+         if (cur == '*') {
+            bool prev_is_star = false;
+            while (_str >> cur) {
+               if (prev_is_star && cur == '/')
+                  return true;
+               prev_is_star = cur == '*';
+            }
+            _str.throwErr("Unexpected EOF while skipping comment");
+         }
+
+         // '//' comment : skip remaining of the line, the end of the input ends it too.
+         if (cur == '/') {
+            while ((_str >> cur) && cur != '\n');
+            return true;
+         }
+
+         _str.pushBack(cur);
+         return false;
+      }
+
+   protected:
+      const char* _err;
+      SIStream& _str;
+      bool _skip_ws;
+      bool _skip_comment;
+   };
+
+   // Size of the blocks pulled from the istream.
+   static constexpr size_t BLOCK_SIZE = 64 * 1024;
+
+   DecodingOption flags;
+   std::istream* iStr;
+   // Decoding buffer of the keys and strings, reused so only the values kept are allocated.
+   std::string scratch;
+   // '{' or '[' for each open container, shared by the decoders so the depth is checked over the whole input.
+   std::string nesting;
+
+   SIStream(std::istream* in, DecodingOption flag) :
+      flags(flag), iStr(in), _buf(new char[BLOCK_SIZE + 1]), _eof(false) {
+      // Keep the first byte as history so pushBack() work across refill.
+      _base = _cur = _end = _buf.get() + 1;
+      _basePos.line = 0;
+      _basePos.col = -1;
+   }
+
+   // Read straight from memory, data must outlive the SIStream.
+   SIStream(const char* data, size_t size, DecodingOption flag) :
+      flags(flag), iStr(nullptr), _eof(false) {
+      _base = _cur = data;
+      _end = data + size;
+      _basePos.line = 0;
+      _basePos.col = -1;
+   }
+
+   ~SIStream() {
+      // Give back what was read ahead but not consumed so the stream is left right after the parsed value.
+      // On a stream that can't seek (pipe, socket, ...) seekg() fails and leaves the fail bit set: the bytes
+      // read ahead are lost, and the next reader sees it rather than take what follows for the next value.
+      if (iStr && _cur < _end) {
+         iStr->clear();
+         iStr->seekg(-(std::streamoff) (_end - _cur), std::ios_base::cur);
+      }
+   }
+
+   // Number the lines from `line`, when the input is a part of a bigger one.
+   void setFirstLine(size_t line) {
+      _basePos.line = line;
+   }
+
+   // Position of the last read character.
+   Pos pos() const {
+      // Put back right after a refill, the character is the history byte.
+      if (_cur < _base) {
+         Pos retVal = _basePos;
+         if (*_cur == '\n')
+            retVal.line--;
+         else
+            retVal.col--;
+         return retVal;
+      }
+      return advance(_basePos, _base, _cur);
+   }
+
+   void throwErr(const std::string& err) const {
+      pos().throwErr(err);
+   }
+
+   MngError operator()(const char* err = nullptr, bool skipWs = true, bool skipCom = true) {
+      return MngError(err, skipWs, skipCom, *this);
+   }
+
+   // Enter a container, throw past the maximum depth.
+   inline void open(char c) {
+      if (nesting.size() >= flags.getMaxDepth())
+         throwErr("Maximum depth exceeded");
+      nesting.push_back(c);
+   }
+
+   // Put back the last read character.
+   inline void pushBack(char c) {
+      if (_eof)
+         return;
+      --_cur;
+   }
+
+   inline int operator >>(char& c) {
+      if (_cur == _end && !fill())
+         return 0;
+      c = *_cur++;
+      return 1;
+   }
+
+   // Give access to the buffered characters, refill the buffer if needed. Return false at end of input.
+   inline bool buffered(const char*& begin, const char*& end) {
+      if (_cur == _end && !fill())
+         return false;
+      begin = _cur;
+      end = _end;
+      return true;
+   }
+
+   // Consume the buffered characters up to p.
+   inline void skip(const char* p) {
+      _cur = p;
+   }
+
+protected:
+   friend class MngError;
+
+   // Position after reading [begin, end) from pos.
+   static Pos advance(Pos pos, const char* begin, const char* end) {
+      const char* nl;
+      while ((nl = (const char*) memchr(begin, '\n', end - begin)) != nullptr) {
+         pos.line++;
+         pos.col = 0;
+         begin = nl + 1;
+      }
+      pos.col += end - begin;
+      return pos;
+   }
+
+   // Pull the next block out of the istream.
+   bool fill() {
+      if (_eof || !iStr) {
+         _eof = true;
+         return false;
+      }
+
+      // The whole block was read, keep its position.
+      _basePos = advance(_basePos, _base, _end);
+
+      char* begin = _buf.get();
+      if (_cur > begin + 1)
+         begin[0] = _cur[-1];
+
+      iStr->read(begin + 1, BLOCK_SIZE);
+      size_t read = iStr->gcount();
+      _base = _cur = begin + 1;
+      _end = _cur + read;
+      _eof = read == 0;
+      return !_eof;
+   }
+
+   std::unique_ptr<char[]> _buf;
+   const char* _base;      // Start of the buffered block.
+   Pos _basePos;           // Position of the character before _base.
+   const char* _cur;
+   const char* _end;
+   bool _eof;
+};
+
+} } // namespace elladan::json
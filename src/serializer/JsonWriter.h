@@ -0,0 +1,109 @@
+/*
+ * JsonWriter.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: daniel
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../json.h"
+#include "JsonHandler.h"
+#include "OutputSink.h"
+
+namespace elladan { namespace json {
+
+/**
+ * Write the events as json text, without building any tree. The text is the one
+ * JsonSerializer::write() gives for the same document. EF_JSON_SORT_KEY is ignored:
+ * the members are written in the order they come. The text is buffered and given to
+ * the output once the root value is complete. A value in an object must follow its key.
+ */
+class JsonWriter : public JsonHandler
+{
+public:
+    JsonWriter(std::ostream* out, EncodingOption flag = EncodingOption());
+    JsonWriter(OutputSink& out, EncodingOption flag = EncodingOption());
+
+    void onNull();
+    void onBool(bool value);
+    void onInt(int64_t value);
+    void onDouble(double value);
+    void onString(const std::string& value);
+    void onBinary(const Binary_t& value);
+    void onUUID(const elladan::UUID& value);
+
+    void onKey(const std::string& key);
+    void onStartObject();
+    void onEndObject();
+    void onStartArray();
+    void onEndArray();
+
+protected:
+    // Delimiter and spacing before a value.
+    void next();
+    void close(const char* end);
+    void done();
+
+    std::unique_ptr<StreamSink> _stream;   // Set when writing to a stream.
+    OutputBuffer _out;
+    EncodingOption _flags;
+    std::string _open;  // '{' or '[' of every open container.
+    bool _first;
+    bool _hasKey;       // A key waits for its value.
+};
+
+/**
+ * Write the events as bson, without building any tree. The root must be an object or an array.
+ * The documents are built in memory, their sizes written back once closed, as BsonSerializer does.
+ * A document is written to the output once its root is closed. EF_JSON_SORT_KEY is ignored.
+ */
+class BsonWriter : public JsonHandler
+{
+public:
+    BsonWriter(std::ostream* out, EncodingOption flag = EncodingOption());
+    BsonWriter(OutputSink& out, EncodingOption flag = EncodingOption());
+
+    void onNull();
+    void onBool(bool value);
+    void onInt(int64_t value);
+    void onDouble(double value);
+    void onString(const std::string& value);
+    void onBinary(const Binary_t& value);
+    void onUUID(const elladan::UUID& value);
+
+    void onKey(const std::string& key);
+    void onStartObject();
+    void onEndObject();
+    void onStartArray();
+    void onEndArray();
+
+protected:
+    // Type and name of the next element.
+    void element(char type);
+    void start(char type);
+    void end(bool isObject);
+
+    struct Level {
+        size_t sizePos;     // Where the size of the document goes.
+        bool isObject;
+        uint32_t count;     // Elements written, the name of the next array element.
+    };
+
+    std::unique_ptr<StreamSink> _stream;   // Set when writing to a stream.
+    OutputSink& _out;
+    EncodingOption _flags;
+    std::string _buf;
+    std::string _key;
+    bool _hasKey;
+    std::vector<Level> _stack;
+};
+
+} } // namespace elladan::json
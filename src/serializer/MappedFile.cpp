@@ -0,0 +1,60 @@
+/*
+ * MappedFile.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: daniel
+ */
+
+#include "MappedFile.h"
+
+#include <elladan/Exception.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cstring>
+
+namespace elladan { namespace json {
+
+MappedFile::MappedFile(const std::string& path) : _data(nullptr), _size(0) {
+   int fd = open(path.c_str(), O_RDONLY);
+   if (fd < 0)
+      throw Exception("Could not open " + path + " : " + strerror(errno));
+
+   struct stat st;
+   if (fstat(fd, &st) < 0) {
+      int err = errno;
+      close(fd);
+      throw Exception("Could not stat " + path + " : " + strerror(err));
+   }
+
+   // Pipes, devices and the like have no size to map.
+   if (!S_ISREG(st.st_mode)) {
+      close(fd);
+      throw Exception("Could not map " + path + " : not a regular file");
+   }
+
+   // Nothing to map in an empty file.
+   _size = st.st_size;
+   if (_size == 0) {
+      close(fd);
+      return;
+   }
+
+   void* addr = mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+   int err = errno;
+   close(fd);
+   if (addr == MAP_FAILED)
+      throw Exception("Could not map " + path + " : " + strerror(err));
+
+   _data = static_cast<const char*>(addr);
+   madvise(addr, _size, MADV_SEQUENTIAL);
+}
+
+MappedFile::~MappedFile() {
+   if (_data)
+      munmap(const_cast<char*>(_data), _size);
+}
+
+} } // namespace elladan::json
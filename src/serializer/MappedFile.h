@@ -0,0 +1,38 @@
+/*
+ * MappedFile.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: daniel
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <string>
+
+namespace elladan { namespace json {
+
+/**
+ * Read only view of a whole regular file, mapped in memory and read ahead sequentially.
+ * The pages are shared with the page cache, nothing is charged against the commit limit.
+ */
+class MappedFile
+{
+public:
+    // Throw if the file can't be opened or mapped, or is not a regular file (pipe, device, ...).
+    MappedFile(const std::string& path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Null for an empty file.
+    const char* data() const { return _data; }
+    size_t size() const { return _size; }
+
+protected:
+    const char* _data;
+    size_t _size;
+};
+
+} } // namespace elladan::json
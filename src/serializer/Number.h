@@ -0,0 +1,55 @@
+/*
+ * Number.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: daniel
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace elladan { namespace json {
+
+class Number
+{
+public:
+    enum Type {
+        NOT_A_NUMBER,
+        INTEGER,
+        REAL,
+    };
+
+    /**
+     * Parse the whole [begin, end) range as a number, without allocating.
+     * Accept json numbers, leading zeros, a missing integer or fraction part (.5, 5.), hexadecimal integers (0xff),
+     * inf and nan. Integers that overflow int64_t are returned as REAL.
+     */
+    static Type parse(const char* begin, const char* end, int64_t& asInt, double& asReal);
+
+    // Size of the buffer formatInt() needs.
+    static constexpr size_t MAX_INT_SIZE = 20;
+
+    // Write value in decimal, return the size written.
+    static size_t formatInt(int64_t value, char* out);
+
+    // Size of the buffer formatReal() needs.
+    static constexpr size_t MAX_REAL_SIZE = 352;
+
+    /**
+     * Write value as a real, always with a fraction or an exponent so it reads back as a real. Return the size written.
+     * With a precision of 0, the shortest text that reads back as the same double (Grisu2 : the shortest for all but
+     * a few values, always exact). Otherwise that many digits after the point, as printf("%.*f").
+     */
+    static size_t formatReal(double value, int precision, char* out);
+
+protected:
+    // Closest double to mantissa * 10^exp10, mantissa must hold at most 19 digits.
+    static bool toDouble(uint64_t mantissa, int64_t exp10, double& out);
+
+    static size_t formatShortest(double value, char* out);
+    static size_t formatFixed(double value, int precision, char* out);
+};
+
+} } // namespace elladan::json
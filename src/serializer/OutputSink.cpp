@@ -0,0 +1,70 @@
+/*
+ * OutputSink.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: daniel
+ */
+
+#include "OutputSink.h"
+
+#include <elladan/Exception.h>
+#include <errno.h>
+#include <unistd.h>
+#include <algorithm>
+
+namespace elladan { namespace json {
+
+OutputSink::~OutputSink() {}
+
+void StreamSink::write(const char* data, size_t size) {
+   _out->write(data, size);
+}
+
+void StringSink::write(const char* data, size_t size) {
+   _out.append(data, size);
+}
+
+void BufferSink::write(const char* data, size_t size) {
+   if (_size < _capacity)
+      memcpy(_buffer + _size, data, std::min(size, _capacity - _size));
+   _size += size;
+}
+
+void FdSink::write(const char* data, size_t size) {
+   while (size) {
+      ssize_t len = ::write(_fd, data, size);
+      if (len < 0) {
+         if (errno == EINTR)
+            continue;
+         throw Exception(std::string("Could not write : ") + strerror(errno));
+      }
+      data += len;
+      size -= len;
+   }
+}
+
+void OutputBuffer::flush() {
+   if (_used) {
+      _sink.write(_buf, _used);
+      _used = 0;
+   }
+}
+
+// Larger than what is left : fill the block, and give what remains of a large write straight to the sink.
+void OutputBuffer::writeLarge(const char* data, size_t size) {
+   size_t len = BLOCK_SIZE - _used;
+   memcpy(_buf + _used, data, len);
+   _used += len;
+   flush();
+   data += len;
+   size -= len;
+
+   if (size >= BLOCK_SIZE)
+      _sink.write(data, size);
+   else {
+      memcpy(_buf, data, size);
+      _used = size;
+   }
+}
+
+} } // namespace elladan::json
@@ -0,0 +1,115 @@
+/*
+ * OutputSink.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: daniel
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+namespace elladan { namespace json {
+
+/**
+ * Where the serializers write to. Gets the output in large blocks, see OutputBuffer.
+ */
+class OutputSink
+{
+public:
+    virtual ~OutputSink();
+    virtual void write(const char* data, size_t size) = 0;
+};
+
+class StreamSink : public OutputSink
+{
+public:
+    StreamSink(std::ostream* out) : _out(out) {}
+    void write(const char* data, size_t size);
+
+protected:
+    std::ostream* _out;
+};
+
+// Append to a string.
+class StringSink : public OutputSink
+{
+public:
+    StringSink(std::string& out) : _out(out) {}
+    void write(const char* data, size_t size);
+
+protected:
+    std::string& _out;
+};
+
+/**
+ * Fill a buffer given by the caller. What does not fit is dropped but counted,
+ * size() gives the size the whole output needs (as snprintf).
+ */
+class BufferSink : public OutputSink
+{
+public:
+    BufferSink(char* buffer, size_t capacity) : _buffer(buffer), _capacity(capacity), _size(0) {}
+    void write(const char* data, size_t size);
+
+    size_t size() const { return _size; }
+    bool overflow() const { return _size > _capacity; }
+
+protected:
+    char* _buffer;
+    size_t _capacity;
+    size_t _size;
+};
+
+// Write to a file descriptor, throw on error.
+class FdSink : public OutputSink
+{
+public:
+    FdSink(int fd) : _fd(fd) {}
+    void write(const char* data, size_t size);
+
+protected:
+    int _fd;
+};
+
+/**
+ * Gather the small writes of the serializers and give them to the sink in blocks.
+ * Call flush() once done, nothing is written on destruction.
+ */
+class OutputBuffer
+{
+public:
+    OutputBuffer(OutputSink& sink) : _sink(sink), _used(0) {}
+
+    OutputBuffer(const OutputBuffer&) = delete;
+    OutputBuffer& operator=(const OutputBuffer&) = delete;
+
+    void write(const char* data, size_t size) {
+        if (size <= BLOCK_SIZE - _used) {
+            memcpy(_buf + _used, data, size);
+            _used += size;
+        }
+        else
+            writeLarge(data, size);
+    }
+    void put(char c) {
+        if (_used == BLOCK_SIZE)
+            flush();
+        _buf[_used++] = c;
+    }
+    void flush();
+
+protected:
+    static constexpr size_t BLOCK_SIZE = 64 * 1024;
+
+    void writeLarge(const char* data, size_t size);
+
+    OutputSink& _sink;
+    size_t _used;
+    char _buf[BLOCK_SIZE];
+};
+
+} } // namespace elladan::json
@@ -0,0 +1,105 @@
+/*
+ * StringScan.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: daniel
+ */
+
+#include "StringScan.h"
+
+#include <cstdint>
+#include <cstring>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace elladan { namespace json {
+
+static inline bool isSpecial(char c) {
+   return c == '"' || c == '\\' || (unsigned char) c < 0x20;
+}
+
+const char* StringScan::findSpecial(const char* begin, const char* end) {
+   const char* ite = begin;
+
+#ifdef __SSE2__
+   const __m128i quote = _mm_set1_epi8('"');
+   const __m128i backslash = _mm_set1_epi8('\\');
+   const __m128i control = _mm_set1_epi8(0x1F);
+
+   for (; end - ite >= 16; ite += 16) {
+      __m128i v = _mm_loadu_si128((const __m128i*) ite);
+      __m128i special = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, quote), _mm_cmpeq_epi8(v, backslash)),
+                                     _mm_cmpeq_epi8(_mm_min_epu8(v, control), v));
+      int mask = _mm_movemask_epi8(special);
+      if (mask)
+         return ite + __builtin_ctz(mask);
+   }
+#else
+   static constexpr uint64_t ONES = 0x0101010101010101ULL;
+   static constexpr uint64_t HIGHS = 0x8080808080808080ULL;
+
+   for (; end - ite >= 8; ite += 8) {
+      uint64_t v;
+      memcpy(&v, ite, sizeof(v));
+      uint64_t q = v ^ (ONES * '"');
+      uint64_t b = v ^ (ONES * '\\');
+      uint64_t special = ((q - ONES) & ~q) | ((b - ONES) & ~b) | ((v - ONES * 0x20) & ~v);
+      if (special & HIGHS)
+         break;
+   }
+#endif
+
+   for (; ite < end; ite++)
+      if (isSpecial(*ite))
+         return ite;
+   return end;
+}
+
+static inline bool isEscaped(char c, bool slash) {
+   return isSpecial(c) || (unsigned char) c >= 0x80 || (slash && c == '/');
+}
+
+const char* StringScan::findEscape(const char* begin, const char* end, bool slash) {
+   const char* ite = begin;
+
+#ifdef __SSE2__
+   const __m128i quote = _mm_set1_epi8('"');
+   const __m128i backslash = _mm_set1_epi8('\\');
+   const __m128i control = _mm_set1_epi8(0x1F);
+   const __m128i solidus = _mm_set1_epi8(slash ? '/' : '"');
+
+   for (; end - ite >= 16; ite += 16) {
+      __m128i v = _mm_loadu_si128((const __m128i*) ite);
+      __m128i special = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, quote), _mm_cmpeq_epi8(v, backslash)),
+                                     _mm_or_si128(_mm_cmpeq_epi8(_mm_min_epu8(v, control), v), _mm_cmpeq_epi8(v, solidus)));
+      // The high bit of v itself flags the non ascii bytes.
+      int mask = _mm_movemask_epi8(_mm_or_si128(special, v));
+      if (mask)
+         return ite + __builtin_ctz(mask);
+   }
+#else
+   static constexpr uint64_t ONES = 0x0101010101010101ULL;
+   static constexpr uint64_t HIGHS = 0x8080808080808080ULL;
+   const uint64_t solidus = ONES * (slash ? '/' : '"');
+
+   for (; end - ite >= 8; ite += 8) {
+      uint64_t v;
+      memcpy(&v, ite, sizeof(v));
+      uint64_t q = v ^ (ONES * '"');
+      uint64_t b = v ^ (ONES * '\\');
+      uint64_t s = v ^ solidus;
+      uint64_t special = ((q - ONES) & ~q) | ((b - ONES) & ~b) | ((s - ONES) & ~s) | ((v - ONES * 0x20) & ~v) | v;
+      if (special & HIGHS)
+         break;
+   }
+#endif
+
+   for (; ite < end; ite++)
+      if (isEscaped(*ite, slash))
+         return ite;
+   return end;
+}
+
+} } // namespace elladan::json
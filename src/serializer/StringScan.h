@@ -0,0 +1,27 @@
+/*
+ * StringScan.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: daniel
+ */
+
+#pragma once
+
+#include <stddef.h>
+
+namespace elladan { namespace json {
+
+/**
+ * Find the characters that end a run of plain string characters, 16 bytes at a time with SSE2,
+ * 8 bytes at a time otherwise.
+ */
+class StringScan
+{
+public:
+    // Return the first quote, backslash or control character (< 0x20) in [begin, end), end if none.
+    static const char* findSpecial(const char* begin, const char* end);
+    // Return the first character a json string can't hold as is : quote, backslash, control, non ascii, and slash if asked.
+    static const char* findEscape(const char* begin, const char* end, bool slash);
+};
+
+} } // namespace elladan::json
@@ -0,0 +1,224 @@
+/*
+ * StructuralIndex.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: daniel
+ */
+
+#include "StructuralIndex.h"
+
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define JSON_INDEX_X86
+#endif
+
+namespace elladan { namespace json {
+
+// Bit i of each mask is set if byte i of the block is of that class.
+struct BlockMasks {
+   uint64_t quote;
+   uint64_t backslash;
+   uint64_t op;
+   uint64_t ws;
+};
+
+static constexpr size_t BLOCK = 64;
+
+enum CharClass : uint8_t {
+   CC_QUOTE     = 1 << 0,
+   CC_BACKSLASH = 1 << 1,
+   CC_OP        = 1 << 2,
+   CC_WS        = 1 << 3,
+};
+
+struct ClassTable {
+   uint8_t value[256];
+   ClassTable() {
+      memset(value, 0, sizeof(value));
+      value[(uint8_t)'"'] = CC_QUOTE;
+      value[(uint8_t)'\\'] = CC_BACKSLASH;
+      for (char c : {'{', '}', '[', ']', ':', ','})
+         value[(uint8_t)c] = CC_OP;
+      for (char c : {' ', '\t', '\n', '\r'})
+         value[(uint8_t)c] = CC_WS;
+   }
+};
+static const ClassTable classTable;
+
+static void classifyScalar(const char* in, BlockMasks& m) {
+   m.quote = m.backslash = m.op = m.ws = 0;
+   for (size_t i = 0; i < BLOCK; i++) {
+      uint8_t cc = classTable.value[(uint8_t)in[i]];
+      m.quote     |= (uint64_t)((cc & CC_QUOTE) != 0) << i;
+      m.backslash |= (uint64_t)((cc & CC_BACKSLASH) != 0) << i;
+      m.op        |= (uint64_t)((cc & CC_OP) != 0) << i;
+      m.ws        |= (uint64_t)((cc & CC_WS) != 0) << i;
+   }
+}
+
+#ifdef JSON_INDEX_X86
+
+__attribute__((target("sse2")))
+static inline uint64_t maskSse2(__m128i v0, __m128i v1, __m128i v2, __m128i v3) {
+   return (uint64_t)(uint16_t)_mm_movemask_epi8(v0)
+        | (uint64_t)(uint16_t)_mm_movemask_epi8(v1) << 16
+        | (uint64_t)(uint16_t)_mm_movemask_epi8(v2) << 32
+        | (uint64_t)(uint16_t)_mm_movemask_epi8(v3) << 48;
+}
+
+__attribute__((target("sse2")))
+static inline __m128i eqSse2(__m128i v, char c) {
+   return _mm_cmpeq_epi8(v, _mm_set1_epi8(c));
+}
+
+__attribute__((target("sse2")))
+static inline __m128i opSse2(__m128i v) {
+   return _mm_or_si128(_mm_or_si128(_mm_or_si128(eqSse2(v, '{'), eqSse2(v, '}')), _mm_or_si128(eqSse2(v, '['), eqSse2(v, ']'))),
+                       _mm_or_si128(eqSse2(v, ':'), eqSse2(v, ',')));
+}
+
+__attribute__((target("sse2")))
+static inline __m128i wsSse2(__m128i v) {
+   return _mm_or_si128(_mm_or_si128(eqSse2(v, ' '), eqSse2(v, '\t')), _mm_or_si128(eqSse2(v, '\n'), eqSse2(v, '\r')));
+}
+
+__attribute__((target("sse2")))
+static void classifySse2(const char* in, BlockMasks& m) {
+   __m128i v0 = _mm_loadu_si128((const __m128i*) in);
+   __m128i v1 = _mm_loadu_si128((const __m128i*) (in + 16));
+   __m128i v2 = _mm_loadu_si128((const __m128i*) (in + 32));
+   __m128i v3 = _mm_loadu_si128((const __m128i*) (in + 48));
+
+   m.quote     = maskSse2(eqSse2(v0, '"'), eqSse2(v1, '"'), eqSse2(v2, '"'), eqSse2(v3, '"'));
+   m.backslash = maskSse2(eqSse2(v0, '\\'), eqSse2(v1, '\\'), eqSse2(v2, '\\'), eqSse2(v3, '\\'));
+   m.op        = maskSse2(opSse2(v0), opSse2(v1), opSse2(v2), opSse2(v3));
+   m.ws        = maskSse2(wsSse2(v0), wsSse2(v1), wsSse2(v2), wsSse2(v3));
+}
+
+__attribute__((target("avx2")))
+static inline uint64_t maskAvx2(__m256i lo, __m256i hi) {
+   return (uint64_t)(uint32_t)_mm256_movemask_epi8(lo) | (uint64_t)(uint32_t)_mm256_movemask_epi8(hi) << 32;
+}
+
+__attribute__((target("avx2")))
+static inline __m256i eqAvx2(__m256i v, char c) {
+   return _mm256_cmpeq_epi8(v, _mm256_set1_epi8(c));
+}
+
+__attribute__((target("avx2")))
+static inline __m256i opAvx2(__m256i v) {
+   return _mm256_or_si256(_mm256_or_si256(_mm256_or_si256(eqAvx2(v, '{'), eqAvx2(v, '}')), _mm256_or_si256(eqAvx2(v, '['), eqAvx2(v, ']'))),
+                          _mm256_or_si256(eqAvx2(v, ':'), eqAvx2(v, ',')));
+}
+
+__attribute__((target("avx2")))
+static inline __m256i wsAvx2(__m256i v) {
+   return _mm256_or_si256(_mm256_or_si256(eqAvx2(v, ' '), eqAvx2(v, '\t')), _mm256_or_si256(eqAvx2(v, '\n'), eqAvx2(v, '\r')));
+}
+
+__attribute__((target("avx2")))
+static void classifyAvx2(const char* in, BlockMasks& m) {
+   __m256i lo = _mm256_loadu_si256((const __m256i*) in);
+   __m256i hi = _mm256_loadu_si256((const __m256i*) (in + 32));
+
+   m.quote     = maskAvx2(eqAvx2(lo, '"'), eqAvx2(hi, '"'));
+   m.backslash = maskAvx2(eqAvx2(lo, '\\'), eqAvx2(hi, '\\'));
+   m.op        = maskAvx2(opAvx2(lo), opAvx2(hi));
+   m.ws        = maskAvx2(wsAvx2(lo), wsAvx2(hi));
+}
+
+#endif
+
+typedef void (*ClassifyFunc)(const char* in, BlockMasks& m);
+
+static ClassifyFunc selectClassify() {
+#ifdef JSON_INDEX_X86
+   __builtin_cpu_init();
+   if (__builtin_cpu_supports("avx2"))
+      return classifyAvx2;
+   if (__builtin_cpu_supports("sse2"))
+      return classifySse2;
+#endif
+   return classifyScalar;
+}
+
+// Set bit i if any of bit 0..i is set an odd number of time.
+static inline uint64_t prefixXor(uint64_t x) {
+   x ^= x << 1;
+   x ^= x << 2;
+   x ^= x << 4;
+   x ^= x << 8;
+   x ^= x << 16;
+   x ^= x << 32;
+   return x;
+}
+
+// Find the characters escaped by an odd sequence of backslash.
+static inline uint64_t escapedChars(uint64_t backslash, uint64_t& prevEndsOddBackslash) {
+   static constexpr uint64_t EVEN_BITS = 0x5555555555555555ULL;
+   static constexpr uint64_t ODD_BITS = ~EVEN_BITS;
+
+   uint64_t startEdges = backslash & ~(backslash << 1);
+   uint64_t evenStartMask = EVEN_BITS ^ prevEndsOddBackslash;
+   uint64_t evenStarts = startEdges & evenStartMask;
+   uint64_t oddStarts = startEdges & ~evenStartMask;
+   uint64_t evenCarries = backslash + evenStarts;
+
+   uint64_t oddCarries = backslash + oddStarts;
+   bool endsOddBackslash = oddCarries < backslash;
+   oddCarries |= prevEndsOddBackslash;
+   prevEndsOddBackslash = endsOddBackslash ? 1 : 0;
+
+   uint64_t evenCarryEnds = evenCarries & ~backslash;
+   uint64_t oddCarryEnds = oddCarries & ~backslash;
+   return (evenCarryEnds & ODD_BITS) | (oddCarryEnds & EVEN_BITS);
+}
+
+bool StructuralIndex::build(const char* data, size_t size, std::vector<uint32_t>& index) {
+   if (size >= UINT32_MAX)
+      return false;
+
+   static const ClassifyFunc classify = selectClassify();
+
+   index.clear();
+   index.reserve(size / 8 + 16);
+
+   uint64_t prevEndsOddBackslash = 0;
+   uint64_t prevInString = 0;
+   uint64_t prevAtom = 0;
+
+   for (size_t base = 0; base < size; base += BLOCK) {
+      BlockMasks m;
+      if (size - base >= BLOCK)
+         classify(data + base, m);
+      else {
+         // Pad the last block with white spaces.
+         char tail[BLOCK];
+         memset(tail, ' ', BLOCK);
+         memcpy(tail, data + base, size - base);
+         classify(tail, m);
+      }
+
+      uint64_t quote = m.quote & ~escapedChars(m.backslash, prevEndsOddBackslash);
+
+      // Opening quote and string content, the closing quote is outside.
+      uint64_t inString = prefixXor(quote) ^ prevInString;
+      prevInString = (uint64_t) ((int64_t) inString >> 63);
+
+      uint64_t atom = ~(inString | quote | m.op | m.ws);
+      uint64_t atomStart = atom & ~((atom << 1) | prevAtom);
+      prevAtom = atom >> 63;
+
+      uint64_t bits = (m.op & ~inString) | quote | atomStart;
+      while (bits) {
+         index.push_back(base + __builtin_ctzll(bits));
+         bits &= bits - 1;
+      }
+   }
+
+   return true;
+}
+
+} } // namespace elladan::json
@@ -0,0 +1,30 @@
+/*
+ * StructuralIndex.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: daniel
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+namespace elladan { namespace json {
+
+/**
+ * First pass of the two pass json parser.
+ * Scan the input 64 bytes at a time (AVX2 or SSE2 when available, scalar otherwise) and record the offset of :
+ * - every structural character {}[]:, outside of strings;
+ * - every unescaped quote (both the opening and closing one);
+ * - the first character of every other token (number, true, false, null, ...).
+ */
+class StructuralIndex
+{
+public:
+    // Return false if the input can't be indexed (too large for 32 bits offsets).
+    static bool build(const char* data, size_t size, std::vector<uint32_t>& index);
+};
+
+} } // namespace elladan::json
@@ -13,8 +13,10 @@
 #include <string>
 #include <vector>
 #include <fstream>
+#include <cstdio>
 
 #include "Test.h"
+#include "../src/serializer/JsonWriter.h"
 
 using std::to_string;
 
@@ -270,6 +272,11 @@ std::string testBsonExtract(){
         return retVal;
     }
 
+    std::string raw = str.str();
+    cp = Json::parse(raw, DecodingOption(), StreamFormat::BSON);
+    if (cp->cmp(root.get()) != 0)
+        retVal += "\n Could not parse complex object from memory";
+
     str.seekg(std::istream::beg);
     result = Json::extract(&str, DecodingOption(), StreamFormat::BSON, "/child1/sub1/val7");
     if (result.size() != 1) {
@@ -348,10 +355,326 @@ std::string testBsonExtract(){
     return retVal;
 }
 
+std::string testBsonMaxDepth(){
+    std::string retVal;
+    DecodingOption raised;
+    raised.setMaxDepth(5000);
+
+    std::string nested;
+    for (int i = 0; i < 2000; i++)
+        nested += "{\"a\":[";
+    nested += "1";
+    for (int i = 0; i < 2000; i++)
+        nested += "]}";
+
+    try {
+        std::stringstream bson;
+        Json::parse(nested, raised, StreamFormat::JSON)->write(&bson, EncodingOption(), StreamFormat::BSON);
+        std::string raw = bson.str();
+
+        if (Json::parse(raw, raised, StreamFormat::BSON) != Json::parse(nested, raised, StreamFormat::JSON))
+            retVal += "\n Invalid document under a raised depth";
+
+        try {
+            Json::parse(raw, DecodingOption(), StreamFormat::BSON);
+            retVal += "\n Document deeper than the default limit accepted";
+        }
+        catch (std::exception& e) {
+            if (std::string(e.what()).find("Maximum depth exceeded") == std::string::npos)
+                retVal += "\n Invalid depth error : " + std::string(e.what());
+        }
+    }
+    catch (std::exception& e) {
+        retVal += "\n Could not parse deep document ";
+        retVal += e.what();
+    }
+
+    // Deeper than the call stack would take, the path search does not recurse.
+    try {
+        size_t deep = 1000000;
+        std::string text;
+        for (size_t i = 0; i < deep; i++)
+            text += "{\"a\":[";
+        text += "{\"x\": 1}";
+        for (size_t i = 0; i < deep; i++)
+            text += "]}";
+        DecodingOption deeper;
+        deeper.setMaxDepth(2 * deep + 10);
+
+        std::stringstream bson;
+        BsonWriter writer(&bson);
+        Json::parse(text.data(), text.size(), writer, deeper, StreamFormat::JSON);
+        std::vector<Json_t> result = Json::extract(&bson, deeper, StreamFormat::BSON, "/**/x");
+        if (result.size() != 1 || result.front() != std::make_shared<JsonInt>(1))
+            retVal += "\n Invalid value extracted from a very deep document";
+    }
+    catch (std::exception& e) {
+        retVal += "\n Could not extract from a very deep document ";
+        retVal += e.what();
+    }
+
+    return retVal;
+}
+
+std::string testBsonDuplicate(){
+    std::string retVal;
+
+    try {
+        std::stringstream bson;
+        Json::parse("{\"a\": 1, \"b\": 2}", DecodingOption(), StreamFormat::JSON)->write(&bson, EncodingOption(), StreamFormat::BSON);
+        std::string raw = bson.str();
+        // Rename "b" to "a".
+        raw[raw.find(std::string("b\0", 2))] = 'a';
+
+        Json_t obj = Json::parse(raw, DecodingOption(), StreamFormat::BSON);
+        if (obj != Json::parse("{\"a\": 2}", DecodingOption(), StreamFormat::JSON))
+            retVal += "\n Invalid duplicate key value";
+
+        try {
+            Json::parse(raw, DF_REJECT_DUPLICATE, StreamFormat::BSON);
+            retVal += "\n Duplicate key accepted";
+        }
+        catch (std::exception& e) {
+            if (std::string(e.what()).find("Duplicate value a at location") == std::string::npos)
+                retVal += "\n Invalid duplicate error : " + std::string(e.what());
+        }
+    }
+    catch (std::exception& e) {
+        retVal += "\n Could not parse duplicate key ";
+        retVal += e.what();
+    }
+
+    return retVal;
+}
+
+std::string testBsonSortKey(){
+    std::string retVal;
+
+    try {
+        std::stringstream sorted, expected;
+        Json::parse("{\"b\": [0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, {\"y\": 1, \"x\": 2}], \"a\": null}", DecodingOption(DecodingFlags::DF_ALLOW_NULL), StreamFormat::JSON)
+                ->write(&sorted, EncodingOption(EncodingFlags::EF_JSON_SORT_KEY), StreamFormat::BSON);
+        Json::parse("{\"a\": null, \"b\": [0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, {\"x\": 2, \"y\": 1}]}", DecodingOption(DecodingFlags::DF_ALLOW_NULL), StreamFormat::JSON)
+                ->write(&expected, EncodingOption(), StreamFormat::BSON);
+        if (sorted.str() != expected.str())
+            retVal += "\n Invalid bson with sorted keys";
+    }
+    catch (std::exception& e) {
+        retVal += "\n Could not write sorted keys ";
+        retVal += e.what();
+    }
+
+    return retVal;
+}
+
+std::string testBsonReadFile(){
+    std::string retVal;
+    const char* fileName = "mapped.bson";
+
+    JsonObject_t root = std::make_shared<JsonObject>();
+    root->value["name"] = std::make_shared<JsonString>("mapped");
+    root->value["bin"] = std::make_shared<JsonBinary>(std::make_shared<Binary>(std::string("0123456789abcdef")));
+    JsonArray_t list = std::make_shared<JsonArray>();
+    list->value.push_back(std::make_shared<JsonInt>(1));
+    list->value.push_back(std::make_shared<JsonBinary>(std::make_shared<Binary>(std::string("ff00"))));
+    root->value["list"] = list;
+
+    {
+        std::ofstream file(fileName, std::ios::binary);
+        root->write(&file, EncodingOption(), StreamFormat::BSON);
+    }
+
+    try {
+        if (Json::readFile(fileName, DecodingOption(), StreamFormat::BSON) != root)
+            retVal += "\n Invalid document read from file";
+
+        // The binaries keep the mapping.
+        Json_t borrowed = Json::readFile(fileName, DF_BORROW_BINARY, StreamFormat::BSON);
+        if (borrowed != root)
+            retVal += "\n Invalid document read from file with borrowed binaries";
+
+        std::vector<Json_t> result = Json::extractFile(fileName, DF_BORROW_BINARY, StreamFormat::BSON, "/list/1");
+        if (result.size() != 1 || result.front() != list->value[1])
+            retVal += "\n Invalid binary extracted from file";
+    }
+    catch (std::exception& e) {
+        retVal += "\n Could not read file ";
+        retVal += e.what();
+    }
+    std::remove(fileName);
+
+    try {
+        Json::readFile("missing.bson", DecodingOption(), StreamFormat::BSON);
+        retVal += "\n Missing file read";
+    }
+    catch (std::exception& e) {
+    }
+
+    return retVal;
+}
+
+std::string testBsonTruncated(){
+    std::string retVal;
+
+    std::stringstream bson;
+    Json::parse("{\"a\": 1, \"b\": [true, \"text\"]}", DecodingOption(), StreamFormat::JSON)->write(&bson, EncodingOption(), StreamFormat::BSON);
+    std::string data = bson.str();
+
+    // Every cut of the document is an error, from memory as from a stream.
+    for (size_t size = 0; size < data.size(); size++) {
+        try {
+            Json::parse(data.data(), size, DecodingOption(), StreamFormat::BSON);
+            retVal += "\n Truncated document accepted from memory at size " + to_string(size);
+        }
+        catch (std::exception& e) {
+        }
+        try {
+            std::stringstream ss(data.substr(0, size));
+            Json::read(&ss, DecodingOption(), StreamFormat::BSON);
+            retVal += "\n Truncated document accepted from a stream at size " + to_string(size);
+        }
+        catch (std::exception& e) {
+        }
+        try {
+            std::stringstream ss(data.substr(0, size));
+            Json::extract(&ss, DecodingOption(), StreamFormat::BSON, "/**/a");
+            retVal += "\n Truncated document searched at size " + to_string(size);
+        }
+        catch (std::exception& e) {
+        }
+    }
+
+    // A size prefix past the end of the memory.
+    try {
+        std::string oversized = data;
+        *(uint32_t*) &oversized[0] = data.size() + 1;
+        Json::parse(oversized.data(), oversized.size(), DecodingOption(), StreamFormat::BSON);
+        retVal += "\n Oversized document accepted";
+    }
+    catch (std::exception& e) {
+        if (std::string(e.what()).find("Invalid document size") == std::string::npos)
+            retVal += "\n Invalid oversized error : " + std::string(e.what());
+    }
+
+    // A failed stream reports no location.
+    try {
+        std::stringstream ss(data.substr(0, 4));
+        Json::read(&ss, DecodingOption(), StreamFormat::BSON);
+    }
+    catch (std::exception& e) {
+        if (std::string(e.what()).find("18446744073709551615") != std::string::npos)
+            retVal += "\n Invalid location of a failed stream : " + std::string(e.what());
+    }
+
+    return retVal;
+}
+
+std::string testBsonDocuments(){
+    std::string retVal;
+
+    std::stringstream bson;
+    for (int i = 0; i < 5000; i++)
+        Json::parse("{\"id\": " + to_string(i) + ", \"name\": \"record " + to_string(i) + "\", \"list\": [1, 2.5]}",
+                    DecodingOption(), StreamFormat::JSON)->write(&bson, EncodingOption(), StreamFormat::BSON);
+    std::string data = bson.str();
+
+    for (unsigned threads : {1, 4}) {
+        try {
+            std::stringstream ss(data);
+            std::vector<Json_t> documents = Json::readBsonDocuments(&ss, DecodingOption(), threads);
+            if (documents.size() != 5000)
+                retVal += "\n Invalid number of documents " + to_string(documents.size());
+            for (size_t i = 0; i < documents.size(); i++) {
+                if (documents[i]->getType() != JSON_OBJECT || documents[i]->toObject()->value["id"] != std::make_shared<JsonInt>(i)) {
+                    retVal += "\n Invalid document " + to_string(i);
+                    break;
+                }
+            }
+
+            size_t count = 0;
+            std::stringstream again(data);
+            Json::readBsonDocuments(&again, [&](const Json_t& document) {
+                if (document->toObject()->value["id"] != std::make_shared<JsonInt>(count++))
+                    retVal += "\n Invalid document from callback";
+            }, DecodingOption(), threads);
+            if (count != 5000)
+                retVal += "\n Invalid number of documents from callback";
+        }
+        catch (std::exception& e) {
+            retVal += "\n Could not read bson documents ";
+            retVal += e.what();
+        }
+
+        // Truncated last document.
+        try {
+            std::stringstream ss(data.substr(0, data.size() - 3));
+            Json::readBsonDocuments(&ss, DecodingOption(), threads);
+            retVal += "\n Truncated document accepted";
+        }
+        catch (std::exception& e) {
+            if (std::string(e.what()).find("Truncated document at location") == std::string::npos)
+                retVal += "\n Invalid truncated error : " + std::string(e.what());
+        }
+
+        // Size prefix cutting off the end of the second document.
+        try {
+            std::string cut = data;
+            uint32_t first = *(const uint32_t*) cut.data();
+            uint32_t second = *(const uint32_t*) (cut.data() + first);
+            *(uint32_t*) &cut[first] = second - 1;
+            cut.erase(first + second - 1, 1);
+            std::stringstream ss(cut);
+            Json::readBsonDocuments(&ss, DecodingOption(), threads);
+            retVal += "\n Document without its end accepted";
+        }
+        catch (std::exception& e) {
+            if (std::string(e.what()).find("in the document 1 at location " + to_string(*(const uint32_t*) data.data())) == std::string::npos)
+                retVal += "\n Invalid error for a document without its end : " + std::string(e.what());
+        }
+
+        // Garbage after the end of the second document, within its size.
+        try {
+            std::string padded = data;
+            uint32_t first = *(const uint32_t*) padded.data();
+            uint32_t second = *(const uint32_t*) (padded.data() + first);
+            *(uint32_t*) &padded[first] = second + 3;
+            padded.insert(first + second, "abc");
+            std::stringstream ss(padded);
+            Json::readBsonDocuments(&ss, DecodingOption(), threads);
+            retVal += "\n Document with trailing garbage accepted";
+        }
+        catch (std::exception& e) {
+            if (std::string(e.what()).find("Document 1 at location " + to_string(*(const uint32_t*) data.data()) + " ends after") == std::string::npos)
+                retVal += "\n Invalid error for a document with trailing garbage : " + std::string(e.what());
+        }
+
+        // Broken document, reported at its location in the whole input.
+        try {
+            std::string broken = data;
+            size_t second = *(const uint32_t*) broken.data();
+            broken[second + 4] = 0x7F;
+            std::stringstream ss(broken);
+            Json::readBsonDocuments(&ss, DecodingOption(), threads);
+            retVal += "\n Broken document accepted";
+        }
+        catch (std::exception& e) {
+            if (std::string(e.what()).find("in the document 1 at location " + to_string(*(const uint32_t*) data.data())) == std::string::npos)
+                retVal += "\n Invalid broken error : " + std::string(e.what());
+        }
+    }
+
+    return retVal;
+}
 
 int main(int argc, char **argv) {
 	bool valid = true;
 	EXE_TEST(testBsonToTxt());
 	EXE_TEST(testBsonExtract());
+	EXE_TEST(testBsonMaxDepth());
+	EXE_TEST(testBsonDuplicate());
+	EXE_TEST(testBsonSortKey());
+	EXE_TEST(testBsonReadFile());
+	EXE_TEST(testBsonTruncated());
+	EXE_TEST(testBsonDocuments());
 	return valid ? 0 : -1;
 }
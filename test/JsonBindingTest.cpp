@@ -0,0 +1,209 @@
+/*
+ * JsonBindingTest.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: daniel
+ */
+
+#include <elladan/FlagSet.h>
+#include <exception>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "Test.h"
+#include "../src/serializer/JsonBinding.h"
+
+using std::to_string;
+
+namespace shop {
+
+enum class Status { OPEN = 1, CLOSED = 2 };
+
+struct Item {
+    std::string name;
+    int32_t count = 0;
+    double price = 0;
+};
+JSON_BIND(Item, JSON_FIELD(name), JSON_FIELD(count), JSON_FIELD(price))
+
+struct Order {
+    int64_t id = 0;
+    Status status = Status::OPEN;
+    bool paid = false;
+    std::string customer;
+    std::vector<Item> items;
+    std::vector<int64_t> tags;
+};
+JSON_BIND(Order, JSON_FIELD(id), JSON_FIELD(status), JSON_FIELD(paid),
+          JSON_FIELD_AS("customer_name", customer), JSON_FIELD(items), JSON_FIELD(tags))
+
+enum class Level : uint8_t { LOW = 1, HIGH = 200 };
+
+struct Limits {
+    uint8_t small = 0;
+    int16_t signedSmall = 0;
+    uint64_t large = 0;
+    Level level = Level::LOW;
+};
+JSON_BIND(Limits, JSON_FIELD(small), JSON_FIELD(signedSmall), JSON_FIELD(large), JSON_FIELD(level))
+
+} // namespace shop
+
+static const std::string Document =
+        "{\"id\":42,\"status\":2,\"paid\":true,\"extra\":{\"a\":[1,{\"b\":2}],\"items\":[]},\"customer_name\":\"caf\\u00e9\","
+        "\"items\":[{\"name\":\"pen\",\"count\":3,\"price\":1.5},{\"name\":\"ink\",\"unknown\":[],\"count\":1,\"price\":7}],"
+        "\"tags\":[1,2,3]}";
+
+std::string testParse() {
+    std::string retVal;
+
+    try {
+        shop::Order order;
+        JsonBinding::parse(Document, order, DecodingOption(), StreamFormat::JSON);
+
+        if (order.id != 42 || order.status != shop::Status::CLOSED || !order.paid || order.customer != "caf\xc3\xa9")
+            retVal += "\nInvalid order";
+        if (order.items.size() != 2 || order.items[0].name != "pen" || order.items[0].count != 3 || order.items[0].price != 1.5)
+            retVal += "\nInvalid first item";
+        if (order.items.size() != 2 || order.items[1].name != "ink" || order.items[1].price != 7)
+            retVal += "\nInvalid second item";
+        if (order.tags != std::vector<int64_t>({1, 2, 3}))
+            retVal += "\nInvalid tags";
+
+        // Reading again replaces the arrays.
+        JsonBinding::parse(Document, order, DecodingOption(), StreamFormat::JSON);
+        if (order.items.size() != 2 || order.tags.size() != 3)
+            retVal += "\nArrays not replaced";
+    }
+    catch (std::exception& e) {
+        retVal += "\nCould not bind ";
+        retVal += e.what();
+    }
+
+    // Type errors.
+    std::vector<std::pair<std::string, std::string>> types = {
+        {"{\"id\": \"42\"}", "JSON_INTEGER"}, {"{\"items\": {}}", "JSON_ARRAY"}, {"{\"paid\": null}", "JSON_BOOL"}, {"[1]", "JSON_OBJECT"},
+    };
+    for (const auto& type : types) {
+        try {
+            shop::Order order;
+            JsonBinding::parse(type.first.c_str(), type.first.size(), order, DF_ALLOW_NULL, StreamFormat::JSON);
+            retVal += "\nInvalid type accepted in " + type.first;
+        }
+        catch (std::exception& e) {
+            if (std::string(e.what()) != "Invalid format, expected " + type.second)
+                retVal += "\nInvalid error : " + std::string(e.what());
+        }
+    }
+
+    return retVal;
+}
+
+std::string testWrite() {
+    std::string retVal;
+
+    try {
+        shop::Order order;
+        JsonBinding::parse(Document, order, DecodingOption(), StreamFormat::JSON);
+
+        // Same output as the tree of the same document.
+        Json_t tree = Json::parse(
+                "{\"id\":42,\"status\":2,\"paid\":true,\"customer_name\":\"caf\\u00e9\","
+                "\"items\":[{\"name\":\"pen\",\"count\":3,\"price\":1.5},{\"name\":\"ink\",\"count\":1,\"price\":7.0}],"
+                "\"tags\":[1,2,3]}", DecodingOption(), StreamFormat::JSON);
+
+        for (int indent : {0, 3, EncodingOption::MAX_INDENT_AS_TAB}) {
+            EncodingOption opt;
+            opt.setIndent(indent);
+            std::stringstream bound, expected;
+            JsonBinding::write(&bound, order, opt, StreamFormat::JSON);
+            tree->write(&expected, opt, StreamFormat::JSON);
+            if (bound.str() != expected.str())
+                retVal += "\nInvalid json with indent " + to_string(indent) + " : " + bound.str();
+        }
+
+        std::stringstream bound, expected;
+        JsonBinding::write(&bound, order, EncodingOption(), StreamFormat::BSON);
+        tree->write(&expected, EncodingOption(), StreamFormat::BSON);
+        if (bound.str() != expected.str())
+            retVal += "\nInvalid bson";
+
+        // And back.
+        shop::Order copy;
+        JsonBinding::read(&bound, copy, DecodingOption(), StreamFormat::BSON);
+        if (copy.id != 42 || copy.customer != order.customer || copy.items.size() != 2 || copy.items[1].price != 7 || copy.tags.size() != 3)
+            retVal += "\nInvalid order read from bson";
+    }
+    catch (std::exception& e) {
+        retVal += "\nCould not write ";
+        retVal += e.what();
+    }
+
+    return retVal;
+}
+
+std::string testRange() {
+    std::string retVal;
+
+    try {
+        shop::Limits limits;
+        JsonBinding::parse(std::string("{\"small\": 255, \"signedSmall\": -32768, \"large\": 9223372036854775807, \"level\": 200}"),
+                           limits, DecodingOption(), StreamFormat::JSON);
+        if (limits.small != 255 || limits.signedSmall != -32768 || limits.large != 9223372036854775807ull || limits.level != shop::Level::HIGH)
+            retVal += "\nInvalid limits";
+    }
+    catch (std::exception& e) {
+        retVal += "\nCould not bind the limits ";
+        retVal += e.what();
+    }
+
+    // Values out of the range of the member.
+    for (const char* txt : {"{\"small\": 300}", "{\"small\": -1}", "{\"signedSmall\": 32768}", "{\"large\": -1}", "{\"level\": 256}"}) {
+        try {
+            shop::Limits limits;
+            JsonBinding::parse(txt, strlen(txt), limits, DecodingOption(), StreamFormat::JSON);
+            retVal += std::string("\nOut of range value accepted in ") + txt;
+        }
+        catch (std::exception& e) {
+            if (std::string(e.what()).find("Invalid format") == std::string::npos)
+                retVal += "\nInvalid error : " + std::string(e.what());
+        }
+    }
+
+    // A value of another type names the expected one.
+    for (const char* txt : {"{\"small\": \"1\"}", "{\"large\": 1.5}", "{\"level\": [200]}"}) {
+        try {
+            shop::Limits limits;
+            JsonBinding::parse(txt, strlen(txt), limits, DecodingOption(), StreamFormat::JSON);
+            retVal += std::string("\nInvalid type accepted in ") + txt;
+        }
+        catch (std::exception& e) {
+            if (std::string(e.what()) != "Invalid format, expected JSON_INTEGER")
+                retVal += "\nInvalid type error : " + std::string(e.what());
+        }
+    }
+
+    // Json integers are signed.
+    try {
+        shop::Limits limits;
+        limits.large = 9223372036854775808ull;
+        std::stringstream out;
+        JsonBinding::write(&out, limits, EncodingOption(), StreamFormat::JSON);
+        retVal += "\nOut of range value written : " + out.str();
+    }
+    catch (std::exception& e) {
+        if (std::string(e.what()).find("Invalid format") == std::string::npos)
+            retVal += "\nInvalid error : " + std::string(e.what());
+    }
+
+    return retVal;
+}
+
+int main(int argc, char **argv) {
+	bool valid = true;
+	EXE_TEST(testParse());
+	EXE_TEST(testWrite());
+	EXE_TEST(testRange());
+	return valid ? 0 : -1;
+}
@@ -0,0 +1,212 @@
+/*
+ * JsonDocumentTest.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: daniel
+ */
+
+#include <elladan/FlagSet.h>
+#include <algorithm>
+#include <cstring>
+#include <exception>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "Test.h"
+#include "../src/serializer/JsonDocument.h"
+
+using std::to_string;
+
+static const std::string Document =
+        "{\"name\": \"caf\\u00e9\", \"list\": [1, -2.5e3, true, null, {}],\n"
+        " \"sub\": {\"a\": \"x\\\"y\", \"b\": [[], [12345678901234]]}, \"bad\": [1, 2x]}";
+
+std::string testNavigate() {
+    std::string retVal;
+    DecodingOption opt = DecodingOption(DecodingFlags::DF_ALLOW_NULL);
+
+    try {
+        JsonDocument doc(Document.data(), Document.size(), opt);
+        JsonDocument::Value root = doc.root();
+        if (root.getType() != JSON_OBJECT || root.size() != 4 || root.key(2) != "sub")
+            retVal += "\nInvalid root";
+
+        JsonDocument::Value list = root["list"];
+        if (list.getType() != JSON_ARRAY || list.size() != 5 || list[4].size() != 0)
+            retVal += "\nInvalid list";
+        if (list[1].get() != Json::parse("-2.5e3", opt, StreamFormat::JSON) || list[3].getType() != JSON_NULL)
+            retVal += "\nInvalid list element";
+
+        if (root["name"].get() != Json::parse("\"caf\\u00e9\"", opt, StreamFormat::JSON))
+            retVal += "\nInvalid escaped string";
+        if (root["sub"].toObject() != Json::parse("{\"a\": \"x\\\"y\", \"b\": [[], [12345678901234]]}", opt, StreamFormat::JSON))
+            retVal += "\nInvalid sub object";
+        if (root["sub"]["b"][1].toArray()->value.size() != 1)
+            retVal += "\nInvalid nested array";
+
+        // Same values as the tree.
+        Json_t tree = Json::parse(Document.substr(0, Document.find(", \"bad\"")) + "}", opt, StreamFormat::JSON);
+        for (const char* path : {"/sub/**/0", "/list/*", "/*/b/1", "/none", "/sub/**", "/sub/*", "/list"}) {
+            std::vector<Json_t> found = doc.getChild(path);
+            std::vector<Json_t> expected = Json::getChild(tree, path);
+            if (found.size() != expected.size() || !std::equal(found.begin(), found.end(), expected.begin(),
+                    [](const Json_t& a, const Json_t& b) { return a == b; }))
+                retVal += std::string("\nInvalid path result for ") + path;
+        }
+    }
+    catch (std::exception& e) {
+        retVal += "\nCould not navigate ";
+        retVal += e.what();
+    }
+
+    // Walk the containers, by index and with the iterators.
+    try {
+        JsonDocument doc(Document.data(), Document.size(), opt);
+        JsonDocument::Value list = doc.root()["list"];
+        Json_t tree = list.get();
+        size_t i = 0;
+        for (JsonDocument::Value ele : list) {
+            if (i >= list.size() || ele.get() != tree->toArray()->value[i] || list[i].get() != ele.get())
+                retVal += "\nInvalid element " + to_string(i);
+            i++;
+        }
+        if (i != list.size())
+            retVal += "\nInvalid number of elements walked " + to_string(i);
+
+        JsonDocument::Value sub = doc.root()["sub"];
+        std::string keys;
+        for (JsonDocument::Iterator ite = sub.begin(); ite != sub.end(); ++ite)
+            keys += ite.key() + "=" + to_string((*ite).size()) + " ";
+        if (keys != "a=0 b=2 ")
+            retVal += "\nInvalid members walked " + keys;
+
+        if (list[0].begin() != list[0].end() || list[4].begin() != list[4].end())
+            retVal += "\nValues walked in an empty container";
+    }
+    catch (std::exception& e) {
+        retVal += "\nCould not walk the containers ";
+        retVal += e.what();
+    }
+
+    // Deeper than the call stack would take.
+    try {
+        size_t levels = 1000000;
+        std::string deep;
+        for (size_t i = 0; i < levels; i++)
+            deep += "{\"a\":[";
+        deep += "{\"x\": 1}";
+        for (size_t i = 0; i < levels; i++)
+            deep += "]}";
+        DecodingOption raised;
+        raised.setMaxDepth(2 * levels + 10);
+        JsonDocument doc(deep.data(), deep.size(), raised);
+        std::vector<Json_t> found = doc.getChild("/**/x");
+        if (found.size() != 1 || found.front() != std::make_shared<JsonInt>(1))
+            retVal += "\nInvalid value found in a very deep document";
+    }
+    catch (std::exception& e) {
+        retVal += "\nCould not search a very deep document ";
+        retVal += e.what();
+    }
+
+    // Missing member, index out of range.
+    try {
+        JsonDocument doc(Document.data(), Document.size(), opt);
+        doc.root()["missing"];
+        retVal += "\nMissing member found";
+    }
+    catch (std::exception& e) {
+    }
+    try {
+        JsonDocument doc(Document.data(), Document.size(), opt);
+        doc.root()["list"][5];
+        retVal += "\nElement out of range found";
+    }
+    catch (std::exception& e) {
+    }
+
+    // Repeated keys, the last value is kept as in the tree.
+    try {
+        std::string txt = "{\"a\": 1, \"b\": 2, \"a\": 3}";
+        JsonDocument doc(txt.data(), txt.size(), DecodingOption());
+        if (doc.root()["a"].get() != Json::parse("3", DecodingOption(), StreamFormat::JSON))
+            retVal += "\nInvalid repeated key";
+        if (doc.root().get() != Json::parse(txt, DecodingOption(), StreamFormat::JSON))
+            retVal += "\nInvalid object with a repeated key";
+    }
+    catch (std::exception& e) {
+        retVal += "\nCould not read repeated keys ";
+        retVal += e.what();
+    }
+
+    return retVal;
+}
+
+std::string testErrors() {
+    std::string retVal;
+    DecodingOption opt = DecodingOption(DecodingFlags::DF_ALLOW_NULL);
+
+    // A broken value is only reported once it is built, at its position.
+    std::string expected;
+    try {
+        Json::parse(Document, opt, StreamFormat::JSON);
+    }
+    catch (std::exception& e) {
+        expected = e.what();
+    }
+    try {
+        std::stringstream ss(Document);
+        JsonDocument doc(&ss, opt);
+        doc.root()["list"][0].get();
+        try {
+            doc.root()["bad"].get();
+            retVal += "\nBroken value accepted";
+        }
+        catch (std::exception& e) {
+            if (e.what() != expected)
+                retVal += "\nInvalid value error : " + std::string(e.what()) + " instead of " + expected;
+        }
+    }
+    catch (std::exception& e) {
+        retVal += "\nCould not record the document ";
+        retVal += e.what();
+    }
+
+    // Structural errors are reported right away, as by Json::parse.
+    for (const char* txt : {"[1, 2", "{\"a\" 1}", "[1 2]", "{\"a\": 1]"}) {
+        std::string err;
+        try {
+            Json::parse(txt, DecodingOption(), StreamFormat::JSON);
+        }
+        catch (std::exception& e) {
+            err = e.what();
+        }
+
+        try {
+            JsonDocument doc(txt, strlen(txt), DecodingOption());
+            retVal += std::string("\nInvalid document accepted ") + txt;
+        }
+        catch (std::exception& e) {
+            if (e.what() != err)
+                retVal += "\nInvalid error : " + std::string(e.what()) + " instead of " + err;
+        }
+    }
+
+    // Comments can't be recorded on the tape.
+    try {
+        JsonDocument doc("[1]", 3, DecodingOption(DecodingFlags::DF_IGNORE_COMMENT));
+        retVal += "\nComments accepted";
+    }
+    catch (std::exception& e) {
+    }
+
+    return retVal;
+}
+
+int main(int argc, char **argv) {
+	bool valid = true;
+	EXE_TEST(testNavigate());
+	EXE_TEST(testErrors());
+	return valid ? 0 : -1;
+}
@@ -0,0 +1,241 @@
+/*
+ * JsonHandlerTest.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: daniel
+ */
+
+#include <elladan/FlagSet.h>
+#include <exception>
+#include <functional>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "Test.h"
+#include "../src/serializer/JsonHandler.h"
+#include "../src/serializer/JsonWriter.h"
+
+using std::to_string;
+
+// Write down every event, keys and values included.
+class TraceHandler : public JsonHandler
+{
+public:
+    std::string trace;
+
+    void onNull()                           { trace += "n "; }
+    void onBool(bool value)                 { trace += value ? "t " : "f "; }
+    void onInt(int64_t value)               { trace += "i" + to_string(value) + " "; }
+    void onDouble(double value)             { trace += "d "; }
+    void onString(const std::string& value) { trace += "s" + value + " "; }
+    void onBinary(const Binary_t& value)    { trace += "b" + to_string(value->size) + " "; }
+    void onUUID(const elladan::UUID& value) { trace += "u "; }
+    void onKey(const std::string& key)      { trace += key + ": "; }
+    void onStartObject()                    { trace += "{ "; }
+    void onEndObject()                      { trace += "} "; }
+    void onStartArray()                     { trace += "[ "; }
+    void onEndArray()                       { trace += "] "; }
+};
+
+static const std::string Document =
+        "{\"a\": 1, \"b\": [true, false, null, 2.5, \"txt\"], \"c\": {\"d\": {}, \"e\": []}}";
+static const std::string Expected =
+        "{ a: i1 b: [ t f n d stxt ] c: { d: { } e: [ ] } } ";
+
+std::string testJsonEvents() {
+    std::string retVal;
+    DecodingOption opt = DecodingOption(DecodingFlags::DF_ALLOW_NULL);
+
+    try {
+        TraceHandler handler;
+        Json::parse(Document.c_str(), Document.size(), handler, opt, StreamFormat::JSON);
+        if (handler.trace != Expected)
+            retVal += "\nInvalid events from memory : " + handler.trace;
+    }
+    catch (std::exception& e) {
+        retVal += "\nCould not parse from memory ";
+        retVal += e.what();
+    }
+
+    try {
+        TraceHandler handler;
+        std::istringstream str(Document + " 3");
+        Json::read(&str, handler, opt, StreamFormat::JSON);
+        if (handler.trace != Expected)
+            retVal += "\nInvalid events from stream : " + handler.trace;
+
+        // The stream is left right after the value.
+        TraceHandler next;
+        Json::read(&str, next, opt, StreamFormat::JSON);
+        if (next.trace != "i3 ")
+            retVal += "\nInvalid events for second value : " + next.trace;
+    }
+    catch (std::exception& e) {
+        retVal += "\nCould not read from stream ";
+        retVal += e.what();
+    }
+
+    try {
+        TraceHandler handler;
+        Json::parse("[1, ", 4, handler, opt, StreamFormat::JSON);
+        retVal += "\nTruncated document was accepted";
+    }
+    catch (std::exception& e) {
+    }
+
+    // Duplicate keys are only rejected by the tree builder.
+    try {
+        TraceHandler handler;
+        std::string dup = "{\"a\": 1, \"a\": 2}";
+        Json::parse(dup.c_str(), dup.size(), handler, DecodingOption(DecodingFlags::DF_REJECT_DUPLICATE), StreamFormat::JSON);
+        if (handler.trace != "{ a: i1 a: i2 } ")
+            retVal += "\nInvalid events for duplicate keys : " + handler.trace;
+
+        JsonBuilder builder(DecodingOption(DecodingFlags::DF_REJECT_DUPLICATE));
+        Json::parse(dup.c_str(), dup.size(), builder, DecodingOption(DecodingFlags::DF_REJECT_DUPLICATE), StreamFormat::JSON);
+        retVal += "\nDuplicate keys were accepted by the builder";
+    }
+    catch (std::exception& e) {
+    }
+
+    // The builder holds one root, a second value is not silently kept instead.
+    for (const std::string& txt : {std::string("1"), std::string("{}"), std::string("[1]")}) {
+        JsonBuilder builder;
+        Json::parse(txt.c_str(), txt.size(), builder, opt, StreamFormat::JSON);
+        try {
+            builder.value(2);
+            retVal += "\nSecond root value accepted after " + txt;
+        }
+        catch (std::exception& e) {
+            if (std::string(e.what()) != "Value after the root value")
+                retVal += "\nInvalid error for a second root value : " + std::string(e.what());
+        }
+        if (builder.get() != Json::parse(txt, opt, StreamFormat::JSON))
+            retVal += "\nRoot replaced by a second value after " + txt;
+    }
+
+    return retVal;
+}
+
+std::string testBsonEvents() {
+    std::string retVal;
+    DecodingOption opt = DecodingOption(DecodingFlags::DF_ALLOW_NULL);
+
+    try {
+        Json_t doc = Json::parse(Document, opt, StreamFormat::JSON);
+        std::stringstream bson;
+        doc->write(&bson, EncodingOption(), StreamFormat::BSON);
+        std::string raw = bson.str();
+
+        TraceHandler handler;
+        Json::parse(raw.c_str(), raw.size(), handler, opt, StreamFormat::BSON);
+        if (handler.trace != Expected)
+            retVal += "\nInvalid events from bson : " + handler.trace;
+
+        JsonBuilder builder;
+        Json::read(&bson, builder, opt, StreamFormat::BSON);
+        if (builder.get() != doc)
+            retVal += "\nBuilder did not rebuild the bson document";
+    }
+    catch (std::exception& e) {
+        retVal += "\nCould not parse bson ";
+        retVal += e.what();
+    }
+
+    return retVal;
+}
+
+// The same document, by hand.
+static void writeDocument(JsonHandler& out, const Binary_t& bin, const elladan::UUID& uuid) {
+    out.beginObject()
+        .key("null").value(nullptr)
+        .key("bool").value(true)
+        .key("int").value(-42)
+        .key("large").value((uint64_t) 1 << 40)
+        .key("real").value(0.1)
+        .key("text").value("caf\xc3\xa9 \"quoted\"")
+        .key("string").value(std::string("s"))
+        .key("bin").value(bin)
+        .key("uuid").value(uuid)
+        .key("list").beginArray();
+    for (int i = 0; i < 12; i++)
+        out.value(i);
+    out.beginObject().endObject().beginArray().endArray();
+    out.endArray()
+        .key("empty").beginObject().endObject()
+    .endObject();
+}
+
+std::string testWriters() {
+    std::string retVal;
+
+    Binary_t bin = std::make_shared<Binary>(std::string("00FF10"));
+    elladan::UUID uuid = elladan::UUID::generateUUID();
+
+    JsonBuilder builder;
+    writeDocument(builder, bin, uuid);
+    Json_t tree = builder.get();
+
+    try {
+        // Same bytes as the tree.
+        for (int indent : {0, 3, EncodingOption::MAX_INDENT_AS_TAB}) {
+            EncodingOption opt;
+            opt.setIndent(indent);
+            std::stringstream written, expected;
+            JsonWriter writer(&written, opt);
+            writeDocument(writer, bin, uuid);
+            tree->write(&expected, opt, StreamFormat::JSON);
+            if (written.str() != expected.str())
+                retVal += "\nInvalid json with indent " + to_string(indent) + " : " + written.str();
+        }
+
+        std::string written, expected;
+        StringSink sink(written);
+        BsonWriter writer(sink);
+        writeDocument(writer, bin, uuid);
+        tree->write(expected, EncodingOption(), StreamFormat::BSON);
+        if (written != expected)
+            retVal += "\nInvalid bson";
+    }
+    catch (std::exception& e) {
+        retVal += "\nCould not write ";
+        retVal += e.what();
+    }
+
+    // Misplaced keys and values.
+    std::vector<std::function<void(JsonHandler&)>> invalid = {
+        [](JsonHandler& out) { out.beginObject().value(1); },
+        [](JsonHandler& out) { out.beginArray().key("a"); },
+        [](JsonHandler& out) { out.beginObject().key("a").key("b"); },
+        [](JsonHandler& out) { out.beginObject().key("a").endObject(); },
+        [](JsonHandler& out) { out.beginObject().endArray(); },
+        [](JsonHandler& out) { out.beginArray().endObject(); },
+        [](JsonHandler& out) { out.key("a"); },
+        [](JsonHandler& out) { out.endArray(); },
+    };
+    for (size_t i = 0; i < invalid.size(); i++) {
+        std::stringstream ss;
+        JsonWriter json(&ss);
+        BsonWriter bson(&ss);
+        JsonBuilder built((DecodingOption()));
+        for (JsonHandler* out : {(JsonHandler*) &json, (JsonHandler*) &bson, (JsonHandler*) &built}) {
+            try {
+                invalid[i](*out);
+                retVal += "\nInvalid sequence " + to_string(i) + " accepted";
+            }
+            catch (std::exception& e) {
+            }
+        }
+    }
+
+    return retVal;
+}
+
+int main(int argc, char **argv) {
+	bool valid = true;
+	EXE_TEST(testJsonEvents());
+	EXE_TEST(testBsonEvents());
+	EXE_TEST(testWriters());
+	return valid ? 0 : -1;
+}
@@ -0,0 +1,170 @@
+/*
+ * JsonPushParserTest.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: daniel
+ */
+
+#include <elladan/FlagSet.h>
+#include <algorithm>
+#include <exception>
+#include <string>
+
+#include "Test.h"
+#include "../src/serializer/JsonPushParser.h"
+
+using std::to_string;
+
+static const std::string Document =
+        "{\"name\": \"caf\\u00e9 \\ud83d\\ude00\", \"list\": [1, -2.5e3, true, null, {}],\n"
+        " /* comment */ \"sub\": {\"a\": \"x\\\"y\", \"b\": 12345678901234}}";
+
+// Feed the text in chunks of `step` bytes.
+static size_t feedBy(JsonPushParser& parser, const std::string& txt, size_t step) {
+    size_t ready = 0;
+    for (size_t i = 0; i < txt.size(); i += step)
+        ready += parser.feed(txt.data() + i, std::min(step, txt.size() - i));
+    return ready;
+}
+
+std::string testChunks() {
+    std::string retVal;
+    DecodingOption opt = DecodingOption(DF_ALLOW_NULL | DF_IGNORE_COMMENT);
+
+    try {
+        Json_t expected = Json::parse(Document, opt, StreamFormat::JSON);
+
+        // Any cut, down to a single byte, gives the same value.
+        for (size_t step : {1, 2, 3, 7, 64}) {
+            JsonPushParser parser(opt);
+            size_t ready = feedBy(parser, Document, step);
+            if (ready != 1 || !parser.hasValue() || parser.popValue() != expected)
+                retVal += "\nInvalid value fed by chunks of " + to_string(step);
+            if (parser.inValue())
+                retVal += "\nParser still in a value after " + to_string(step);
+        }
+    }
+    catch (std::exception& e) {
+        retVal += "\nCould not feed chunks ";
+        retVal += e.what();
+    }
+
+    // Several values, a number cut in the middle, the last one only completed by finish().
+    try {
+        JsonPushParser parser(opt);
+        size_t ready = parser.feed("[1] {\"a\"", 8);
+        ready += parser.feed(": 2} 12", 7);
+        if (ready != 2 || !parser.inValue())
+            retVal += "\nInvalid number of values before the end";
+        ready = parser.feed("34", 2);
+        ready += parser.finish();
+        if (ready != 1)
+            retVal += "\nNumber not completed by finish";
+
+        const char* expected[] = {"[1]", "{\"a\": 2}", "1234"};
+        for (const char* txt : expected) {
+            if (!parser.hasValue() || parser.popValue() != Json::parse(txt, opt, StreamFormat::JSON))
+                retVal += std::string("\nInvalid value, expected ") + txt;
+        }
+        if (parser.hasValue())
+            retVal += "\nToo many values";
+    }
+    catch (std::exception& e) {
+        retVal += "\nCould not feed several values ";
+        retVal += e.what();
+    }
+
+    return retVal;
+}
+
+// Write down every event.
+class TraceHandler : public JsonHandler
+{
+public:
+    std::string trace;
+
+    void onInt(int64_t value)               { trace += "i" + to_string(value) + " "; }
+    void onString(const std::string& value) { trace += "s" + value + " "; }
+    void onKey(const std::string& key)      { trace += key + ": "; }
+    void onStartObject()                    { trace += "{ "; }
+    void onEndObject()                      { trace += "} "; }
+    void onStartArray()                     { trace += "[ "; }
+    void onEndArray()                       { trace += "] "; }
+};
+
+std::string testHandler() {
+    std::string retVal;
+
+    try {
+        TraceHandler handler;
+        JsonPushParser parser(handler, DecodingOption());
+        std::string txt = "{\"a\": [1, \"b\"]}";
+        feedBy(parser, txt, 1);
+        // Events come as soon as the characters are known.
+        if (handler.trace != "{ a: [ i1 sb ] } ")
+            retVal += "\nInvalid events : " + handler.trace;
+        if (parser.hasValue())
+            retVal += "\nValue built with a handler";
+    }
+    catch (std::exception& e) {
+        retVal += "\nCould not feed handler ";
+        retVal += e.what();
+    }
+
+    return retVal;
+}
+
+std::string testErrors() {
+    std::string retVal;
+
+    // Error with its position, whatever the cut.
+    try {
+        JsonPushParser parser{DecodingOption()};
+        feedBy(parser, "[1,\n 2,\n \"a\\q\"]", 2);
+        retVal += "\nInvalid escape accepted";
+    }
+    catch (std::exception& e) {
+        if (std::string(e.what()).find("Invalid escape at line 2 column 5") == std::string::npos)
+            retVal += "\nInvalid error : " + std::string(e.what());
+    }
+
+    // Incomplete value at the end.
+    try {
+        JsonPushParser parser{DecodingOption()};
+        parser.feed("{\"a\": \"b", 8);
+        parser.finish();
+        retVal += "\nIncomplete value accepted";
+    }
+    catch (std::exception& e) {
+        if (std::string(e.what()).find("Unexpected EOF") == std::string::npos)
+            retVal += "\nInvalid error : " + std::string(e.what());
+    }
+
+    // The parser can be used again after reset().
+    try {
+        JsonPushParser parser{DecodingOption()};
+        try {
+            parser.feed("[1 2]", 5);
+        }
+        catch (std::exception& e) {
+        }
+        parser.reset();
+        parser.feed("[3]", 3);
+        if (!parser.hasValue() || parser.popValue() != Json::parse("[3]", DecodingOption(), StreamFormat::JSON))
+            retVal += "\nInvalid value after reset";
+    }
+    catch (std::exception& e) {
+        retVal += "\nCould not reset ";
+        retVal += e.what();
+    }
+
+    return retVal;
+}
+
+int main(int argc, char **argv) {
+	bool valid = true;
+	EXE_TEST(testChunks());
+	EXE_TEST(testHandler());
+	EXE_TEST(testErrors());
+	return valid ? 0 : -1;
+}
@@ -0,0 +1,177 @@
+/*
+ * JsonReaderTest.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: daniel
+ */
+
+#include <elladan/FlagSet.h>
+#include <exception>
+#include <sstream>
+#include <string>
+
+#include "Test.h"
+#include "../src/serializer/JsonReader.h"
+
+using std::to_string;
+
+static const std::string Document =
+        "{\"skip\": {\"a\": [1, 2, {\"b\": \"\\u00e9\\\"\"}], \"c\": null},\n"
+        " \"id\": 42, \"name\": \"elladan\", \"ratio\": 0.5, \"ok\": true,\n"
+        " \"list\": [1, \"two\", [3]], \"tree\": {\"x\": 1}}";
+
+std::string testWalk() {
+    std::string retVal;
+    DecodingOption opt = DecodingOption(DecodingFlags::DF_ALLOW_NULL);
+
+    try {
+        JsonReader reader(Document.c_str(), Document.size(), opt);
+        if (reader.next() != JsonReader::TK_START_OBJECT)
+            retVal += "\nExpected start of object";
+
+        int64_t id = 0;
+        std::string name;
+        double ratio = 0;
+        bool ok = false;
+        Json_t tree;
+        while (reader.next() == JsonReader::TK_KEY) {
+            std::string key = reader.getString();
+            if (key == "id")
+                id = reader.readInt64();
+            else if (key == "name")
+                name = reader.readString();
+            else if (key == "ratio")
+                ratio = reader.readDouble();
+            else if (key == "ok")
+                ok = reader.readBool();
+            else if (key == "tree")
+                tree = reader.readValue();
+            else
+                reader.skipValue();
+        }
+
+        if (reader.token() != JsonReader::TK_END_OBJECT)
+            retVal += "\nExpected end of object";
+        if (reader.next() != JsonReader::TK_END)
+            retVal += "\nExpected end of document";
+        if (id != 42 || name != "elladan" || ratio != 0.5 || !ok)
+            retVal += "\nInvalid values read";
+        if (!tree || tree != Json::parse("{\"x\": 1}", opt, StreamFormat::JSON))
+            retVal += "\nInvalid tree read";
+    }
+    catch (std::exception& e) {
+        retVal += "\nCould not walk the document ";
+        retVal += e.what();
+    }
+
+    // Every token in order.
+    try {
+        std::string txt = "[1, \"two\", [3.5, false], {}, null]";
+        JsonReader reader(txt.c_str(), txt.size(), opt);
+        std::string trace;
+        JsonReader::Token tk;
+        while ((tk = reader.next()) != JsonReader::TK_END)
+            trace += to_string(tk) + " ";
+        if (trace != "3 7 6 3 8 9 4 1 2 10 4 ")
+            retVal += "\nInvalid tokens : " + trace;
+    }
+    catch (std::exception& e) {
+        retVal += "\nCould not read tokens ";
+        retVal += e.what();
+    }
+
+    // The stream is left right after the root value.
+    try {
+        std::istringstream str("[1] {\"a\": 2}");
+        {
+            JsonReader reader(&str, opt);
+            reader.skipValue();
+            if (reader.next() != JsonReader::TK_END)
+                retVal += "\nExpected end after first value";
+        }
+        JsonReader reader(&str, opt);
+        if (reader.readValue() != Json::parse("{\"a\": 2}", opt, StreamFormat::JSON))
+            retVal += "\nInvalid second value";
+    }
+    catch (std::exception& e) {
+        retVal += "\nCould not read stream ";
+        retVal += e.what();
+    }
+
+    return retVal;
+}
+
+std::string testErrors() {
+    std::string retVal;
+
+    // Wrong type, error with its position.
+    try {
+        std::string txt = "{\"id\":\n \"42\"}";
+        JsonReader reader(txt.c_str(), txt.size(), DecodingOption());
+        reader.next();
+        reader.next();
+        reader.readInt64();
+        retVal += "\nString read as integer";
+    }
+    catch (std::exception& e) {
+        if (std::string(e.what()).find("Expected an integer at line 1") == std::string::npos)
+            retVal += "\nInvalid error : " + std::string(e.what());
+    }
+
+    // A key is not a string value.
+    try {
+        std::string txt = "{\"id\": \"42\"}";
+        JsonReader reader(txt.c_str(), txt.size(), DecodingOption());
+        reader.next();
+        reader.readString();
+        retVal += "\nKey read as a string";
+    }
+    catch (std::exception& e) {
+        if (std::string(e.what()).find("Expected a string at line 0") == std::string::npos)
+            retVal += "\nInvalid error : " + std::string(e.what());
+    }
+
+    try {
+        std::string txt = "{\"id\": \"42\"}";
+        JsonReader reader(txt.c_str(), txt.size(), DecodingOption());
+        reader.next();
+        if (reader.readKey() != "id" || reader.readString() != "42")
+            retVal += "\nInvalid key and string";
+        reader.readKey();
+        retVal += "\nEnd of object read as a key";
+    }
+    catch (std::exception& e) {
+        if (std::string(e.what()).find("Expected a key") == std::string::npos)
+            retVal += "\nInvalid error : " + std::string(e.what());
+    }
+
+    // Errors inside skipped values are still reported.
+    try {
+        std::string txt = "[{\"a\": [1, 2}, 3]";
+        JsonReader reader(txt.c_str(), txt.size(), DecodingOption());
+        reader.next();
+        reader.skipValue();
+        retVal += "\nBroken skipped value accepted";
+    }
+    catch (std::exception& e) {
+    }
+
+    try {
+        std::string txt = "[\"\\q\"]";
+        JsonReader reader(txt.c_str(), txt.size(), DecodingOption());
+        reader.next();
+        reader.skipValue();
+        retVal += "\nInvalid escape in skipped value accepted";
+    }
+    catch (std::exception& e) {
+    }
+
+    return retVal;
+}
+
+int main(int argc, char **argv) {
+	bool valid = true;
+	EXE_TEST(testWalk());
+	EXE_TEST(testErrors());
+	return valid ? 0 : -1;
+}
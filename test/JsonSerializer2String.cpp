@@ -8,6 +8,10 @@
 #include <elladan/Stringify.h>
 #include <elladan/UUID.h>
 #include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <random>
 #include <memory>
 #include <sstream>
 #include <string>
@@ -23,7 +27,7 @@ static const std::string ExpectNotSorted = "{"
         "\"null\":null,"
         "\"bool\":true,"
         "\"int\":0,"
-        "\"double\":3.141500,"
+        "\"double\":3.1415,"
         "\"string\":\"testing how this work\","
         "\"arr\":[],"
         "\"obj\":{},"
@@ -33,7 +37,7 @@ static const std::string ExpectNotSorted = "{"
 static const std::string ExpectSorted = "{"
         "\"arr\":[],"
         "\"bool\":true,"
-        "\"double\":3.141500,"
+        "\"double\":3.1415,"
         "\"fill_arr\":[0,1,2,3],"
         "\"int\":0,"
         "\"null\":null,"
@@ -45,7 +49,7 @@ static const std::string ExpectWS =
             "\t\"null\" : null,\n"
             "\t\"bool\" : true,\n"
             "\t\"int\" : 0,\n"
-            "\t\"double\" : 3.141500,\n"
+            "\t\"double\" : 3.1415,\n"
             "\t\"string\" : \"testing how this work\",\n"
             "\t\"arr\" : [\n"
             "\t],\n"
@@ -80,7 +84,7 @@ std::string testJsonToTxt(){
     if (str != "10") retVal += "\nCould not stringify JsonInt, expected 10, got " + str + "";
 
     str = to_string(std::make_shared<JsonDouble>(3.1415));
-    if (str != "3.141500") retVal += "\nCould not stringify JsonDouble, expected 3.141500, got " + str + "";
+    if (str != "3.1415") retVal += "\nCould not stringify JsonDouble, expected 3.1415, got " + str + "";
 
     str = to_string(std::make_shared<JsonString>("Testing with \""));
     if (str != "\"Testing with \\\"\"") retVal += "\nCould not stringify JsonString, expected \"Testing with \\\"\", got " + str + "";
@@ -126,8 +130,177 @@ std::string testJsonToTxt(){
     return retVal;
 }
 
+std::string testEscape(){
+    std::string retVal;
+
+    // Long enough for the clean runs to be scanned by blocks.
+    std::string txt = "path/to/a \"file\"\\ with caf\xc3\xa9 and \xf0\x9f\x98\x80,\t\x01 end of a long enough string";
+    std::string expected = "\"path/to/a \\\"file\\\"\\\\ with caf\xc3\xa9 and \xf0\x9f\x98\x80,\\t\\u0001 end of a long enough string\"";
+
+    std::string str = to_string(toJson(txt));
+    if (str != expected)
+        retVal += "\nInvalid escaped string, expected " + expected + " got " + str;
+
+    std::string slash;
+    toJson("a/b")->write(slash, EncodingOption(EncodingFlags::EF_JSON_ESCAPE_SLASH), StreamFormat::JSON);
+    if (slash != "\"a\\/b\"")
+        retVal += "\nInvalid escaped slash " + slash;
+
+    try {
+        std::string ascii;
+        toJson(txt)->write(ascii, EncodingOption(EncodingFlags::EF_JSON_ENSURE_ASCII), StreamFormat::JSON);
+        retVal += "\nNon ascii string accepted " + ascii;
+    }
+    catch (std::exception& e) {
+    }
+
+    // Invalid utf8 ends the string.
+    str = to_string(toJson("abc\xff def"));
+    if (str != "\"abc\"")
+        retVal += "\nInvalid string with invalid utf8 " + str;
+
+    return retVal;
+}
+
+std::string testInteger(){
+    std::string retVal;
+
+    std::vector<int64_t> values = {0, 7, -7, 10, 99, 100, -100, 12345, 1000000, 9999999999LL,
+                                   std::numeric_limits<int64_t>::max(), std::numeric_limits<int64_t>::min()};
+    std::mt19937_64 rng(42);
+    for (int i = 0; i < 10000; i++)
+        values.push_back((int64_t) (rng() >> (rng() % 64)) * (i % 2 ? 1 : -1));
+
+    for (int64_t value : values) {
+        std::string str = to_string(toJson(value));
+        if (str != std::to_string(value))
+            retVal += "\nInvalid integer, expected " + std::to_string(value) + " got " + str;
+    }
+
+    return retVal;
+}
+
+std::string testReal(){
+    std::string retVal;
+
+    // Shortest text, always read back as a real.
+    std::vector<std::pair<double, std::string>> shortest = {
+        {2.7, "2.7"}, {100, "100.0"}, {-0.0, "-0.0"}, {0.1, "0.1"}, {1e-9, "1e-9"}, {0.0001, "0.0001"}, {0.00001, "1e-5"},
+        {123456789012345., "123456789012345.0"}, {1e21, "1e+21"}, {-1.5e300, "-1.5e+300"}, {5e-324, "5e-324"},
+        {std::numeric_limits<double>::max(), "1.7976931348623157e+308"}, {1.0 / 3, "0.3333333333333333"},
+    };
+    for (auto& ite : shortest) {
+        std::string str = to_string(toJson(ite.first));
+        if (str != ite.second)
+            retVal += "\nInvalid real, expected " + ite.second + " got " + str;
+    }
+
+    // Fixed number of digits after the point, rounded as printf from the exact value.
+    std::vector<std::pair<double, int>> fixed = {
+        {2.7, 3}, {0.125, 2}, {2.675, 2}, {1.005, 2}, {-0.0001, 2}, {-1.5, 1}, {1e300, 1}, {123.456, 31}, {4503599627370495.5, 1},
+    };
+    for (auto& ite : fixed) {
+        EncodingOption opt;
+        opt.setRealPrec(ite.second);
+        std::string str;
+        toJson(ite.first)->write(str, opt, StreamFormat::JSON);
+        char expected[400];
+        snprintf(expected, sizeof(expected), "%.*f", ite.second, ite.first);
+        if (str != expected)
+            retVal += "\nInvalid fixed real, expected " + std::string(expected) + " got " + str;
+    }
+
+    // Exact round trip, on random bit patterns.
+    std::mt19937_64 rng(42);
+    JsonArray_t arr = std::make_shared<JsonArray>();
+    for (int i = 0; i < 100000; i++) {
+        uint64_t bits = rng();
+        double value;
+        memcpy(&value, &bits, sizeof(value));
+        if (value == value && value - value == 0)
+            arr->value.push_back(toJson(value));
+    }
+    std::stringstream ss;
+    arr->write(&ss, EncodingOption(), StreamFormat::JSON);
+    try {
+        JsonArray_t copy = std::dynamic_pointer_cast<JsonArray>(Json::read(&ss, DecodingOption(), StreamFormat::JSON));
+        for (size_t i = 0; copy && i < arr->value.size(); i++) {
+            double a = arr->value[i]->toDouble()->value, b = copy->value[i]->toDouble()->value;
+            if (memcmp(&a, &b, sizeof(a)))
+                retVal += "\nReal not read back : " + to_string(arr->value[i]) + " read as " + to_string(copy->value[i]);
+        }
+        if (!copy || copy->value.size() != arr->value.size())
+            retVal += "\nInvalid reals read back";
+    }
+    catch (std::exception& e) {
+        retVal += "\nCould not read the reals back ";
+        retVal += e.what();
+    }
+
+    return retVal;
+}
+
+std::string testSinks(){
+    std::string retVal;
+
+    // Large enough to go through several blocks of the output buffer.
+    JsonArray_t root = std::make_shared<JsonArray>();
+    for (int i = 0; i < 2000; i++) {
+        JsonObject_t ele = std::make_shared<JsonObject>();
+        ele->value["id"] = toJson(i);
+        ele->value["name"] = toJson("element " + to_string(i));
+        ele->value["data"] = std::make_shared<JsonBinary>(std::make_shared<Binary>(std::string(i % 300 ? 8 : 70000 * 2, 'a')));
+        root->value.push_back(ele);
+    }
+
+    for (StreamFormat format : {StreamFormat::JSON, StreamFormat::BSON}) {
+        std::string name = format == StreamFormat::JSON ? "json" : "bson";
+        std::stringstream ss;
+        root->write(&ss, EncodingOption(), format);
+        std::string expected = ss.str();
+
+        std::string str = "prefix";
+        root->write(str, EncodingOption(), format);
+        if (str != "prefix" + expected)
+            retVal += "\nInvalid " + name + " written to a string";
+
+        std::vector<char> buf(expected.size() + 1, 'x');
+        size_t size = root->write(buf.data(), buf.size(), EncodingOption(), format);
+        if (size != expected.size() || std::string(buf.data(), size) != expected || buf.back() != 'x')
+            retVal += "\nInvalid " + name + " written to a buffer";
+
+        // Too small : the beginning is kept, the needed size is returned.
+        std::fill(buf.begin(), buf.end(), 'x');
+        size = root->write(buf.data(), 100, EncodingOption(), format);
+        if (size != expected.size() || std::string(buf.data(), 100) != expected.substr(0, 100) || buf[100] != 'x')
+            retVal += "\nInvalid overflow of the " + name + " buffer";
+
+        FILE* file = tmpfile();
+        root->write(fileno(file), EncodingOption(), format);
+        rewind(file);
+        std::string read(expected.size() + 1, '\0');
+        read.resize(fread(&read[0], 1, read.size(), file));
+        fclose(file);
+        if (read != expected)
+            retVal += "\nInvalid " + name + " written to a file descriptor";
+    }
+
+    try {
+        root->write(-1, EncodingOption(), StreamFormat::JSON);
+        retVal += "\nInvalid file descriptor accepted";
+    }
+    catch (std::exception& e) {
+    }
+
+    return retVal;
+}
+
 int main(int argc, char **argv) {
 	bool valid = true;
 	EXE_TEST(testJsonToTxt());
+	EXE_TEST(testEscape());
+	EXE_TEST(testInteger());
+	EXE_TEST(testReal());
+	EXE_TEST(testSinks());
 	return valid ? 0 : -1;
 }
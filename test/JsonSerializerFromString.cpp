@@ -8,12 +8,16 @@
 #include <elladan/Stringify.h>
 #include <elladan/UUID.h>
 #include <bitset>
+#include <cstdio>
 #include <exception>
+#include <fstream>
 #include <memory>
 #include <sstream>
+#include <stdexcept>
 #include <vector>
 
 #include "Test.h"
+#include "../src/parallel.h"
 
 using std::to_string;
 
@@ -98,8 +102,21 @@ std::string testTxtToJson(){
     test_mode_value ("-200.34", JSON_DOUBLE, DecodingOption(), Double, -200.34)
     test_mode_value ("-200.34e-17", JSON_DOUBLE, DecodingOption(), Double, -200.34e-17)
     test_throw_exep("-20e0.34e-17");
+    test_mode_value ("1E+5", JSON_DOUBLE, DecodingOption(), Double, 1e5)
+    test_mode_value ("0.1", JSON_DOUBLE, DecodingOption(), Double, 0.1)
+    test_mode_value ("1.7976931348623157e308", JSON_DOUBLE, DecodingOption(), Double, 1.7976931348623157e308)
+    test_mode_value ("4.9406564584124654e-324", JSON_DOUBLE, DecodingOption(), Double, 4.9406564584124654e-324)
+    test_mode_value ("123456789012345678901234567890", JSON_DOUBLE, DecodingOption(), Double, 123456789012345678901234567890.)
+    test_mode_value ("-9223372036854775808", JSON_INTEGER, DecodingOption(), Int, INT64_MIN)
+    test_mode_value ("9223372036854775808", JSON_DOUBLE, DecodingOption(), Double, 9223372036854775808.)
+    test_throw_exep("1e");
+    test_throw_exep("--1");
 
     test_mode_value ("\"Some text with \\\"\"", JSON_STRING, DecodingOption(), String, "Some text with \"")
+    test_mode_value ("\"\\u00e9\\uE000\"", JSON_STRING, DecodingOption(), String, "\xC3\xA9\xEE\x80\x80")
+    test_mode_value ("\"\\ud83d\\ude00\"", JSON_STRING, DecodingOption(), String, "\xF0\x9F\x98\x80")
+    test_throw_exep("\"\\ud83d\"");
+    test_throw_exep("\"\\u00g0\"");
 
 
     Json_t obj;
@@ -206,6 +223,39 @@ std::string testTxtToJson(){
     }
     catch (std::exception& e) {    }
 
+    // Large objects, their keys are hashed.
+    {
+        std::string large = "{";
+        for (int i = 0; i < 1000; i++)
+            large += "\"key" + std::to_string(i) + "\":" + std::to_string(i) + ",";
+        try {
+            obj = Json::parse(large + "\"last\":0}", DF_REJECT_DUPLICATE, StreamFormat::JSON);
+            if (std::dynamic_pointer_cast<JsonObject>(obj)->value.size() != 1001)
+                retVal += "\nInvalid number of value in large object";
+        }
+        catch (std::exception& e) {
+            retVal += "\nCould not decode large object ";
+            retVal += e.what();
+        }
+        try {
+            obj = Json::parse(large + "\"key3\":0}", DF_REJECT_DUPLICATE, StreamFormat::JSON);
+            retVal += "\nShould have refused duplicate key in large object";
+        }
+        catch (std::exception& e) {    }
+        try {
+            // Without the flag, the last value wins and keeps the member in place.
+            obj = Json::parse(large + "\"key3\":-3, \"key40\":-40}", DecodingOption(), StreamFormat::JSON);
+            auto& members = std::dynamic_pointer_cast<JsonObject>(obj)->value;
+            if (members.size() != 1000 || (members.begin() + 3)->second != std::make_shared<JsonInt>(-3)
+                    || members["key40"] != std::make_shared<JsonInt>(-40))
+                retVal += "\nInvalid duplicate keys in large object";
+        }
+        catch (std::exception& e) {
+            retVal += "\nCould not decode duplicate keys in large object ";
+            retVal += e.what();
+        }
+    }
+
     try{
         std::stringstream ss;
         ss << "/* Test de commentai\n"
@@ -276,11 +326,459 @@ std::string testTxtToJson(){
         retVal += e.what();
     }
 
+    // Parse straight from memory.
+    try{
+        const std::string txt = "{\"key1\":[1,2,\"three\"],\"key2\":3.1415} trailing";
+        obj = Json::parse(txt.c_str(), txt.size(), DecodingOption(), StreamFormat::JSON);
+        if (obj->getType() != JSON_OBJECT)
+            retVal += "\nCould not parse object from memory";
+        else if (std::dynamic_pointer_cast<JsonObject>(obj)->value.size() != 2)
+            retVal += "\nInvalid number of value parsing object from memory";
+
+        obj = Json::parse(std::string("[1,2"), DecodingOption(), StreamFormat::JSON);
+        retVal += "\nParsing truncated array from memory should have thrown an exception";
+    }
+    catch (std::exception& e) {
+        if (std::string(e.what()).find("Unexpected EOF") == std::string::npos) {
+            retVal += "\nCould not parse from memory ";
+            retVal += e.what();
+        }
+    }
+
+    // Two pass and parallel parsers must give the same result as the sequential one.
+    {
+        std::string large = "[";
+        for (int i = 0; i < 2000; i++)
+            large += std::string(i ? ",\n" : "") + "{\"id\": " + to_string(i) + ", \"v\": [\"]\", " + to_string(i * 0.5) + "]}";
+        large += "]";
+
+        const std::string docs[] = {
+            ExpectWS,
+            "[1,2 3,]",
+            "{\"a\\\"{\":[\"x\\\\\",\"\\u00e9\",{}],\"b\":-7.5e-3, \"c\":0xff}",
+            "[1,{\"a\":2}",
+            "",
+            "[]",
+            " [ ] ",
+            "[1,,2]",
+            "[{\"a\": 1},\n {\"a\": }]",
+            "[1, [2, 3}, 4]",
+            large,
+            large.substr(0, large.size() / 2),
+        };
+        const DecodingOption opts[] = {
+            DecodingOption(DF_ALLOW_NULL | DF_STRUCTURAL_INDEX),
+            DecodingOption(DF_ALLOW_NULL | DF_PARALLEL),
+            DecodingOption(DF_ALLOW_NULL | DF_PARALLEL | DF_STRUCTURAL_INDEX),
+        };
+        for (auto& doc : docs) {
+            std::string seq, idx;
+            try { seq = to_string(Json::parse(doc, DF_ALLOW_NULL, StreamFormat::JSON)); }
+            catch (std::exception& e) { seq = e.what(); }
+            for (auto& opt : opts) {
+                try { idx = to_string(Json::parse(doc, opt, StreamFormat::JSON)); }
+                catch (std::exception& e) { idx = e.what(); }
+                if (seq != idx)
+                    retVal += "\nIndexed parse of \"" + doc.substr(0, 100) + "\" differ, expected " + seq.substr(0, 100) + " got " + idx.substr(0, 100);
+            }
+        }
+    }
+
+    // String spanning several input blocks.
+    try{
+        std::string txt(200000, 'x');
+        txt[70000] = '\n';
+        std::stringstream ss;
+        ss << "\"" << txt.substr(0, 70000) << "\\n" << txt.substr(70001) << "\"";
+        obj = Json::read(&ss, DecodingOption(), StreamFormat::JSON);
+        if (obj->getType() != JSON_STRING || obj->toString()->value != txt)
+            retVal += "\nInvalid value decoding long string";
+    }
+    catch (std::exception& e) {
+        retVal += "\nCould not decode long string ";
+        retVal += e.what();
+    }
+
+    // Read ahead must be given back to the stream.
+    try{
+        std::stringstream ss;
+        ss << "[1,2] {\"key1\":1} 3";
+        obj = Json::read(&ss, DecodingOption(), StreamFormat::JSON);
+        if (obj->getType() != JSON_ARRAY)
+            retVal += "\nCould not decode first value of a multi value stream";
+        obj = Json::read(&ss, DecodingOption(), StreamFormat::JSON);
+        if (obj->getType() != JSON_OBJECT)
+            retVal += "\nCould not decode second value of a multi value stream";
+        obj = Json::read(&ss, DecodingOption(), StreamFormat::JSON);
+        if (obj->getType() != JSON_INTEGER)
+            retVal += "\nCould not decode last value of a multi value stream";
+    }
+    catch (std::exception& e) {
+        retVal += "\nCould not decode multi value stream ";
+        retVal += e.what();
+    }
+
+    return retVal;
+}
+
+std::string testJsonExtract() {
+    std::string retVal;
+    std::string txt =
+            "{\"child0\": [{\"val0\": 1, \"val1\": 2}, {\"val1\": 3, \"str\": \"a\\\"b\"}],"
+            " \"child1\": {\"sub0\": {\"val7\": 7, \"deep\": {\"val7\": [8]}}, \"sub1\": [null, true, 1.5]},"
+            " \"val7\": \"root\"}";
+
+    // Same result as the path applied on the whole tree.
+    const char* paths[] = {"", "/child0", "/child0/1/val1", "/child0/*/val1", "/*", "/**/val7", "/child1/**",
+                           "/child1/sub1/2", "/child1/*/deep/val7/0", "/missing", "/val7/x"};
+    try {
+        Json_t root = Json::parse(txt, DF_ALLOW_NULL, StreamFormat::JSON);
+        for (const char* path : paths) {
+            std::stringstream ss(txt);
+            std::vector<Json_t> result = Json::extract(&ss, DF_ALLOW_NULL, StreamFormat::JSON, path);
+            std::vector<Json_t> expected = Json::getChild(root, path);
+            if (result.size() != expected.size())
+                retVal += std::string("\nInvalid number of elements extracting ") + path;
+            else for (size_t i = 0; i < result.size(); i++)
+                if (result[i] != expected[i])
+                    retVal += std::string("\nInvalid element extracting ") + path;
+        }
+    }
+    catch (std::exception& e) {
+        retVal += "\nCould not extract ";
+        retVal += e.what();
+    }
+
+    // Skipped values must still be valid.
+    try {
+        std::stringstream ss("{\"a\": [1, }, \"b\": 2}");
+        Json::extract(&ss, DecodingOption(), StreamFormat::JSON, "/b");
+        retVal += "\nInvalid skipped value accepted";
+    }
+    catch (std::exception& e) {
+    }
+
+    // A '/' which does not start a comment, in a skipped value.
+    try {
+        std::stringstream ss("{\"a\":[1 / 2],\"b\":3}");
+        Json::extract(&ss, DF_IGNORE_COMMENT, StreamFormat::JSON, "/b");
+        retVal += "\nInvalid '/' accepted in a skipped value";
+    }
+    catch (std::exception& e) {
+        if (std::string(e.what()).find("Unexpected character '/'") == std::string::npos)
+            retVal += "\nInvalid error for a '/' in a skipped value : " + std::string(e.what());
+    }
+
+    // Comments are skipped along with the value.
+    try {
+        std::stringstream ss("{\"a\":[1 /* ] */, 2 // ]\n], \"b\":3}");
+        std::vector<Json_t> result = Json::extract(&ss, DF_IGNORE_COMMENT, StreamFormat::JSON, "/b");
+        if (result.size() != 1 || result.front() != std::make_shared<JsonInt>(3))
+            retVal += "\nInvalid value extracted after comments";
+    }
+    catch (std::exception& e) {
+        retVal += "\nCould not extract after comments ";
+        retVal += e.what();
+    }
+
+    return retVal;
+}
+
+std::string testJsonLines() {
+    std::string retVal;
+
+    std::stringstream txt;
+    for (int i = 0; i < 5000; i++) {
+        txt << "{\"id\": " << i << ", \"name\": \"record " << i << "\", \"list\": [" << i % 7 << ", 2.5]}\n";
+        if (i % 100 == 0)
+            txt << "\r\n  \n";
+    }
+    std::string data = txt.str();
+
+    for (unsigned threads : {1, 4}) {
+        try {
+            std::stringstream ss(data);
+            std::vector<Json_t> records = Json::readLines(&ss, DecodingOption(), threads);
+            if (records.size() != 5000)
+                retVal += "\nInvalid number of records " + to_string(records.size());
+            for (size_t i = 0; i < records.size(); i++) {
+                if (records[i]->getType() != JSON_OBJECT || records[i]->toObject()->value["id"] != std::make_shared<JsonInt>(i)) {
+                    retVal += "\nInvalid record " + to_string(i);
+                    break;
+                }
+            }
+
+            // Last line without newline.
+            std::stringstream last("1\n2\n3");
+            size_t count = 0;
+            Json::readLines(&last, [&](const Json_t& record) {
+                if (record != std::make_shared<JsonInt>(++count))
+                    retVal += "\nInvalid record from callback";
+            }, DecodingOption(), threads);
+            if (count != 3)
+                retVal += "\nInvalid number of records from callback";
+        }
+        catch (std::exception& e) {
+            retVal += "\nCould not read json lines ";
+            retVal += e.what();
+        }
+
+        // The error is reported at its position in the whole input, and for the first bad line.
+        try {
+            std::stringstream ss("1\n[2]\n{\"a\": }\n4 5\n");
+            Json::readLines(&ss, DecodingOption(), threads);
+            retVal += "\nInvalid json lines accepted";
+        }
+        catch (std::exception& e) {
+            if (std::string(e.what()).find("at line 2 column") == std::string::npos)
+                retVal += "\nInvalid json lines error : " + std::string(e.what());
+        }
+
+        try {
+            std::stringstream ss("1\n4 5\n");
+            Json::readLines(&ss, DecodingOption(), threads);
+            retVal += "\nTwo values on a line accepted";
+        }
+        catch (std::exception& e) {
+        }
+    }
+
+    return retVal;
+}
+
+std::string testThreadPool() {
+    std::string retVal;
+
+    // The same threads run one batch after the other.
+    ThreadPool pool(4);
+    for (size_t run = 0; run < 50; run++) {
+        std::vector<size_t> done(run, 0);
+        pool.run(run, [&](size_t i) { done[i] += i + 1; });
+        for (size_t i = 0; i < run; i++)
+            if (done[i] != i + 1) {
+                retVal += "\nTask " + to_string(i) + " not run once in run " + to_string(run);
+                break;
+            }
+    }
+
+    // The lowest failed task is rethrown, and the pool can still be used.
+    try {
+        pool.run(1000, [&](size_t i) {
+            if (i % 100 == 37)
+                throw std::runtime_error("task " + to_string(i));
+        });
+        retVal += "\nFailed task not reported";
+    }
+    catch (std::exception& e) {
+        if (std::string(e.what()) != "task 37")
+            retVal += "\nInvalid failed task " + std::string(e.what());
+    }
+
+    std::atomic<size_t> sum(0);
+    pool.run(100, [&](size_t i) { sum += i; });
+    if (sum != 4950)
+        retVal += "\nPool not usable after a failure";
+
+    return retVal;
+}
+
+std::string testErrorPosition() {
+    std::string retVal;
+
+    // Same position from memory and from a stream, the error being far after the first block.
+    std::string txt = "[";
+    for (int i = 0; i < 5000; i++)
+        txt += "\n  {\"a\": 12, \"b\": \"some text\"},";
+    txt += "\n  {\"a\" 1}]";
+    for (bool fromStream : {false, true}) {
+        try {
+            std::stringstream ss(txt);
+            if (fromStream)
+                Json::read(&ss, DecodingOption(), StreamFormat::JSON);
+            else
+                Json::parse(txt, DecodingOption(), StreamFormat::JSON);
+            retVal += "\nMissing delimiter accepted";
+        }
+        catch (std::exception& e) {
+            if (std::string(e.what()).find("at line 5001 column 8") == std::string::npos)
+                retVal += "\nInvalid error position : " + std::string(e.what());
+        }
+    }
+
+    // Comments running to the end of the input.
+    try {
+        Json::parse("[1, /* open", DF_IGNORE_COMMENT, StreamFormat::JSON);
+        retVal += "\nUnterminated comment accepted";
+    }
+    catch (std::exception& e) {
+        if (std::string(e.what()).find("Unexpected EOF while skipping comment") == std::string::npos)
+            retVal += "\nInvalid comment error : " + std::string(e.what());
+    }
+    try {
+        if (Json::parse("[1] // end", DF_IGNORE_COMMENT, StreamFormat::JSON) != Json::parse("[1]", DecodingOption(), StreamFormat::JSON))
+            retVal += "\nInvalid value before a last line comment";
+    }
+    catch (std::exception& e) {
+        retVal += "\nCould not parse a last line comment ";
+        retVal += e.what();
+    }
+
+    return retVal;
+}
+
+std::string testMaxDepth() {
+    std::string retVal;
+    std::string deep = std::string(100000, '[') + std::string(100000, ']');
+
+    // Far too deep for a recursive parser, refused without using the stack.
+    for (int flag : {0, (int)DF_STRUCTURAL_INDEX, (int)DF_PARALLEL}) {
+        try {
+            Json::parse(deep, DecodingOption(flag), StreamFormat::JSON);
+            retVal += "\nDocument deeper than the default limit accepted";
+        }
+        catch (std::exception& e) {
+            if (std::string(e.what()).find("Maximum depth exceeded at line 0 column 1024") == std::string::npos)
+                retVal += "\nInvalid depth error : " + std::string(e.what());
+        }
+    }
+
+    // Up to the limit.
+    DecodingOption opt;
+    opt.setMaxDepth(3);
+    for (int flag : {0, (int)DF_STRUCTURAL_INDEX, (int)DF_PARALLEL}) {
+        DecodingOption current = opt;
+        current.set(flag);
+        try {
+            Json::parse("[{\"a\": [1]}, {\"b\": []}]", current, StreamFormat::JSON);
+        }
+        catch (std::exception& e) {
+            retVal += "\nCould not parse at the maximum depth ";
+            retVal += e.what();
+        }
+        try {
+            Json::parse("[{\"a\": [1]}, {\"b\": [[]]}]", current, StreamFormat::JSON);
+            retVal += "\nDocument over the limit accepted";
+        }
+        catch (std::exception& e) {
+        }
+    }
+
+    // The whole depth counts while extracting.
+    try {
+        std::stringstream ss("{\"a\": {\"b\": [[1]]}}");
+        Json::extract(&ss, opt, StreamFormat::JSON, "/a/b");
+        retVal += "\nExtracted value over the limit accepted";
+    }
+    catch (std::exception& e) {
+    }
+
+    // A lot deeper than the default, once raised.
+    try {
+        std::string nested;
+        for (int i = 0; i < 5000; i++)
+            nested += "{\"a\":";
+        nested += "1" + std::string(5000, '}');
+        DecodingOption raised;
+        raised.setMaxDepth(5000);
+        std::stringstream ss(nested);
+        Json_t obj = Json::read(&ss, raised, StreamFormat::JSON);
+        size_t depth = 0;
+        while (obj->getType() == JSON_OBJECT) {
+            obj = obj->toObject()->value["a"];
+            depth++;
+        }
+        if (depth != 5000)
+            retVal += "\nInvalid depth " + to_string(depth);
+    }
+    catch (std::exception& e) {
+        retVal += "\nCould not parse under a raised limit ";
+        retVal += e.what();
+    }
+
+    // Deeper than the call stack would take, the path search does not recurse.
+    try {
+        size_t levels = 1000000;
+        std::string nested;
+        for (size_t i = 0; i < levels; i++)
+            nested += "{\"a\":[";
+        nested += "{\"x\": 1}";
+        for (size_t i = 0; i < levels; i++)
+            nested += "]}";
+        DecodingOption raised;
+        raised.setMaxDepth(2 * levels + 10);
+        std::stringstream ss(nested);
+        std::vector<Json_t> result = Json::extract(&ss, raised, StreamFormat::JSON, "/**/x");
+        if (result.size() != 1 || result.front() != std::make_shared<JsonInt>(1))
+            retVal += "\nInvalid value extracted from a very deep document";
+    }
+    catch (std::exception& e) {
+        retVal += "\nCould not extract from a very deep document ";
+        retVal += e.what();
+    }
+
+    return retVal;
+}
+
+std::string testReadFile() {
+    std::string retVal;
+    const char* fileName = "mapped.json";
+    std::string doc = "{\"a\": [1, 2.5, \"x\\ny\"], \"b\": {\"c\": true}}";
+
+    {
+        std::ofstream file(fileName);
+        file << doc;
+    }
+
+    try {
+        if (Json::readFile(fileName, DecodingOption(), StreamFormat::JSON) != Json::parse(doc, DecodingOption(), StreamFormat::JSON))
+            retVal += "\nInvalid document read from file";
+        if (Json::readFile(fileName, DF_STRUCTURAL_INDEX, StreamFormat::JSON) != Json::parse(doc, DecodingOption(), StreamFormat::JSON))
+            retVal += "\nInvalid document read from file with the structural index";
+
+        std::vector<Json_t> result = Json::extractFile(fileName, DecodingOption(), StreamFormat::JSON, "/b/c");
+        if (result.size() != 1 || result.front() != Json::parse("true", DecodingOption(), StreamFormat::JSON))
+            retVal += "\nInvalid value extracted from file";
+    }
+    catch (std::exception& e) {
+        retVal += "\nCould not read file ";
+        retVal += e.what();
+    }
+
+    // Empty file, same as an empty input.
+    {
+        std::ofstream file(fileName, std::ios::trunc);
+    }
+    try {
+        if (Json::readFile(fileName, DecodingOption(), StreamFormat::JSON) != Json::parse("", DecodingOption(), StreamFormat::JSON))
+            retVal += "\nInvalid empty file";
+    }
+    catch (std::exception& e) {
+        retVal += "\nCould not read empty file ";
+        retVal += e.what();
+    }
+    std::remove(fileName);
+
+    // A device has no size, it is not taken for an empty file.
+    try {
+        Json::readFile("/dev/null", DecodingOption(), StreamFormat::JSON);
+        retVal += "\nDevice read as a file";
+    }
+    catch (std::exception& e) {
+        if (std::string(e.what()).find("not a regular file") == std::string::npos)
+            retVal += "\nInvalid error reading a device " + std::string(e.what());
+    }
+
     return retVal;
 }
 
 int main(int argc, char **argv) {
 	bool valid = true;
 	EXE_TEST(testTxtToJson());
+	EXE_TEST(testJsonExtract());
+	EXE_TEST(testJsonLines());
+	EXE_TEST(testThreadPool());
+	EXE_TEST(testErrorPosition());
+	EXE_TEST(testMaxDepth());
+	EXE_TEST(testReadFile());
 	return valid ? 0 : -1;
 }
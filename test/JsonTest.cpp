@@ -68,7 +68,7 @@ do {\
 } while (0);
     TEST(Bool, true, "true");
     TEST(Int, 2, "2");
-    TEST(Double, 2.7, "2.700000");
+    TEST(Double, 2.7, "2.7");
     TEST(String, "test", "\"test\"");
 #undef TEST
 